@@ -0,0 +1,551 @@
+// Runtime microbenchmarks for the reflection paths.
+// Prints one JSON object per benchmark: ns/op and heap allocations/op.
+//
+//     ReflectionBench [min_ms_per_benchmark]
+
+#include "Meta.h"
+#include "MetaCallSite.h"
+#include "MetaColumn.h"
+#include "MetaHash.h"
+#include "MetaJournal.h"
+#include "MetaLog.h"
+#include "MetaMigration.h"
+#include "MetaQuery.h"
+#include "MetaSort.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/****************************************************************/
+//                     Allocation Counting                      //
+/****************************************************************/
+
+namespace
+{
+	std::atomic<size_t> g_allocations(0);
+}
+
+// Every replaceable operator new allocates with std::malloc, so the std::free in every operator delete matches
+// whichever form allocated the block. GCC's -Wmismatched-new-delete can't see that through the replacement and
+// still warns where a delete is inlined after a new, so it is silenced for this file.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	if(void* p = std::malloc(size ? size : 1))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+// Over-allocates and keeps malloc's pointer just before the aligned block, for the aligned deletes to free.
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	size_t align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+	void* base = operator new(size + align);
+	void* p = reinterpret_cast<void*>((reinterpret_cast<uintptr_t>(base) + align) & ~(uintptr_t(align) - 1));
+	static_cast<void**>(p)[-1] = base;
+	return p;
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	try { return operator new(size); } catch(const std::bad_alloc&) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return operator new(size, std::nothrow); }
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	try { return operator new(size, alignment); } catch(const std::bad_alloc&) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return operator new(size, alignment, std::nothrow);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	if(p)
+	{
+		std::free(static_cast<void**>(p)[-1]);
+	}
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept { operator delete(p, alignment); }
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept { operator delete(p, alignment); }
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept { operator delete(p, alignment); }
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { operator delete(p, alignment); }
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept { operator delete(p, alignment); }
+
+/****************************************************************/
+//                           Harness                            //
+/****************************************************************/
+
+namespace
+{
+	// Keeps the optimizer from discarding a value.
+	template<typename T>
+	void DoNotOptimize(const T& value)
+	{
+	#if defined(__GNUC__)
+		asm volatile("" : : "r,m"(value) : "memory");
+	#else
+		static volatile const void* sink;
+		sink = &value;
+	#endif
+	}
+
+	double g_minSeconds = 0.2;
+	bool g_first = true;
+
+	// Doubles the iteration count until a batch runs for g_minSeconds, then reports that batch.
+	template<typename F>
+	void Run(const char* name, F body)
+	{
+		typedef std::chrono::steady_clock clock;
+
+		for(size_t i = 0; i < 1000; ++i)
+		{
+			body();
+		}
+
+		for(size_t iterations = 1000; ; iterations *= 2)
+		{
+			size_t allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+			clock::time_point start = clock::now();
+			for(size_t i = 0; i < iterations; ++i)
+			{
+				body();
+			}
+			double seconds = std::chrono::duration<double>(clock::now() - start).count();
+			size_t allocations = g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+			if(seconds >= g_minSeconds || iterations >= (size_t(1) << 40))
+			{
+				std::printf("%s\n  {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_op\": %.3f, \"allocs_per_op\": %.3f}",
+					g_first ? "" : ",", name, iterations, seconds * 1e9 / iterations, (double)allocations / iterations);
+				g_first = false;
+				return;
+			}
+		}
+	}
+}
+
+/****************************************************************/
+//                       Reflected Types                        //
+/****************************************************************/
+
+namespace ReflectionBench
+{
+	struct Large
+	{
+		double values[16];
+	};
+
+	class Target
+	{
+	public:
+		int a;
+		float b;
+		double c;
+		uint64_t version;
+
+		Target() : a(1), b(2.0f), c(3.0), version(meta::NextVersion()) {}
+
+		int f0() { return a; }
+		int f1(int x1) { return a + x1; }
+		int f2(int x1, int x2) { return a + x1 + x2; }
+		int f3(int x1, int x2, int x3) { return a + x1 + x2 + x3; }
+		int f4(int x1, int x2, int x3, int x4) { return a + x1 + x2 + x3 + x4; }
+		int f5(int x1, int x2, int x3, int x4, int x5) { return a + x1 + x2 + x3 + x4 + x5; }
+		int f6(int x1, int x2, int x3, int x4, int x5, int x6) { return a + x1 + x2 + x3 + x4 + x5 + x6; }
+		int f7(int x1, int x2, int x3, int x4, int x5, int x6, int x7) { return a + x1 + x2 + x3 + x4 + x5 + x6 + x7; }
+		int f8(int x1, int x2, int x3, int x4, int x5, int x6, int x7, int x8) { return a + x1 + x2 + x3 + x4 + x5 + x6 + x7 + x8; }
+
+		// A derived getter worth caching
+		double Expensive(int n) const
+		{
+			double sum = c;
+			for(int i = 1; i <= n; ++i)
+			{
+				sum += 1.0 / (double(i) * i + b);
+			}
+			return sum;
+		}
+
+		// Targets aren't changed while benchmarked, so the version is only taken on construction
+		uint64_t GetVersion() const { return version; }
+
+		meta_declare(Target);
+	};
+
+	meta_define(Target)
+		.member("a", &Target::a)
+		.member("b", &Target::b)
+		.member("c", &Target::c)
+		.method("f0", &Target::f0)
+		.method("f1", &Target::f1)
+		.method("f2", &Target::f2)
+		.method("f3", &Target::f3)
+		.method("f4", &Target::f4)
+		.method("f5", &Target::f5)
+		.method("f6", &Target::f6)
+		.method("f7", &Target::f7)
+		.method("f8", &Target::f8)
+		.method("Expensive", &Target::Expensive)
+		.pure_method("ExpensivePure", &Target::Expensive)
+		.finish();
+
+	struct Matrix
+	{
+		float m[16];
+	};
+
+	// Getters returning a string (past the small string buffer) and a matrix
+	class Camera
+	{
+	public:
+		std::string name;
+		Matrix view;
+
+		Camera() : name("a camera with a name too long for the small string buffer"), view() {}
+
+		std::string GetName() const { return name; }
+		Matrix GetView() const { return view; }
+
+		meta_declare(Camera);
+	};
+
+	// Receivers for call sites that see one, four or eight types
+	#define BENCH_SHAPE(NAME, SIDES)										\
+		class NAME															\
+		{																	\
+		public:																\
+			int Scaled(int scale) const { return SIDES * scale; }			\
+			meta_declare(NAME);												\
+		};																	\
+		meta_define(NAME)													\
+			.method("Scaled", &NAME::Scaled)								\
+			.finish();
+
+	BENCH_SHAPE(Shape0, 3)
+	BENCH_SHAPE(Shape1, 4)
+	BENCH_SHAPE(Shape2, 5)
+	BENCH_SHAPE(Shape3, 6)
+	BENCH_SHAPE(Shape4, 7)
+	BENCH_SHAPE(Shape5, 8)
+	BENCH_SHAPE(Shape6, 9)
+	BENCH_SHAPE(Shape7, 10)
+
+	#undef BENCH_SHAPE
+
+	// Calls Scaled on receiver i % Ways through a site
+	template <unsigned int Ways>
+	int CallShapes(meta::CallSite& site, unsigned int i)
+	{
+		static Shape0 s0; static Shape1 s1; static Shape2 s2; static Shape3 s3;
+		static Shape4 s4; static Shape5 s5; static Shape6 s6; static Shape7 s7;
+		switch(i % Ways)
+		{
+		case 0: return site.Call(s0, 2).cast<int>();
+		case 1: return site.Call(s1, 2).cast<int>();
+		case 2: return site.Call(s2, 2).cast<int>();
+		case 3: return site.Call(s3, 2).cast<int>();
+		case 4: return site.Call(s4, 2).cast<int>();
+		case 5: return site.Call(s5, 2).cast<int>();
+		case 6: return site.Call(s6, 2).cast<int>();
+		default: return site.Call(s7, 2).cast<int>();
+		}
+	}
+
+	// The same calls, looking the name up every time
+	template <unsigned int Ways>
+	int CallShapesByName(unsigned int i)
+	{
+		static Shape0 s0; static Shape1 s1; static Shape2 s2; static Shape3 s3;
+		static Shape4 s4; static Shape5 s5; static Shape6 s6; static Shape7 s7;
+		switch(i % Ways)
+		{
+		case 0: return meta::Invoke(meta::Get(s0)->GetMethod("Scaled"), s0, 2).cast<int>();
+		case 1: return meta::Invoke(meta::Get(s1)->GetMethod("Scaled"), s1, 2).cast<int>();
+		case 2: return meta::Invoke(meta::Get(s2)->GetMethod("Scaled"), s2, 2).cast<int>();
+		case 3: return meta::Invoke(meta::Get(s3)->GetMethod("Scaled"), s3, 2).cast<int>();
+		case 4: return meta::Invoke(meta::Get(s4)->GetMethod("Scaled"), s4, 2).cast<int>();
+		case 5: return meta::Invoke(meta::Get(s5)->GetMethod("Scaled"), s5, 2).cast<int>();
+		case 6: return meta::Invoke(meta::Get(s6)->GetMethod("Scaled"), s6, 2).cast<int>();
+		default: return meta::Invoke(meta::Get(s7)->GetMethod("Scaled"), s7, 2).cast<int>();
+		}
+	}
+
+	// An older layout of Target, for migration
+	struct TargetV1
+	{
+		float b;
+		char a;
+	};
+}
+
+meta_declare_primitive(std::string);
+meta_declare_primitive(ReflectionBench::Matrix);
+
+namespace ReflectionBench
+{
+	meta_define(Camera)
+		.method("GetName", &Camera::GetName)
+		.method("GetView", &Camera::GetView)
+		.finish();
+}
+
+meta_declare_primitive(ReflectionBench::TargetV1)
+	.member("b", &ReflectionBench::TargetV1::b)
+	.member("a", &ReflectionBench::TargetV1::a)
+	.finish();
+
+/****************************************************************/
+//                          Benchmarks                          //
+/****************************************************************/
+
+int main(int argc, const char* argv[])
+{
+	using namespace ReflectionBench;
+
+	if(argc > 1)
+	{
+		g_minSeconds = std::atof(argv[1]) / 1000.0;
+	}
+
+	std::printf("[");
+
+	// Lookup
+	Run("Get<T>", []() { DoNotOptimize(meta::Get<Target>()); });
+	Run("Get<int>", []() { DoNotOptimize(meta::Get<int>()); });
+	Run("Get_Name", []() { DoNotOptimize(meta::Get_Name("ReflectionBench::Target")); });
+
+	const meta::TypeData* type = meta::Get<Target>();
+	Run("GetMember", [type]() { DoNotOptimize(type->GetMember("c")); });
+	Run("GetMethod", [type]() { DoNotOptimize(type->GetMethod("f8")); });
+
+	// Invoke, by arity
+	Target target;
+	const meta::Method* methods[9];
+	for(int i = 0; i < 9; ++i)
+	{
+		methods[i] = type->GetMethod("f" + std::to_string(i));
+	}
+
+	Run("Invoke/0", [&]() { DoNotOptimize(meta::Invoke(methods[0], target)); });
+	Run("Invoke/1", [&]() { DoNotOptimize(meta::Invoke(methods[1], target, 1)); });
+	Run("Invoke/2", [&]() { DoNotOptimize(meta::Invoke(methods[2], target, 1, 2)); });
+	Run("Invoke/3", [&]() { DoNotOptimize(meta::Invoke(methods[3], target, 1, 2, 3)); });
+	Run("Invoke/4", [&]() { DoNotOptimize(meta::Invoke(methods[4], target, 1, 2, 3, 4)); });
+	Run("Invoke/5", [&]() { DoNotOptimize(meta::Invoke(methods[5], target, 1, 2, 3, 4, 5)); });
+	Run("Invoke/6", [&]() { DoNotOptimize(meta::Invoke(methods[6], target, 1, 2, 3, 4, 5, 6)); });
+	Run("Invoke/7", [&]() { DoNotOptimize(meta::Invoke(methods[7], target, 1, 2, 3, 4, 5, 6, 7)); });
+	Run("Invoke/8", [&]() { DoNotOptimize(meta::Invoke(methods[8], target, 1, 2, 3, 4, 5, 6, 7, 8)); });
+
+	// An argument that needs converting (double to int)
+	Run("Invoke/1/converted", [&]() { DoNotOptimize(meta::Invoke(methods[1], target, 1.0)); });
+
+	// By-name calls: cached call sites vs a lookup per call
+	meta::CallSite monomorphic("Scaled"), polymorphic("Scaled"), megamorphic("Scaled");
+	unsigned int callIndex = 0;
+	Run("CallSite/monomorphic", [&]() { DoNotOptimize(CallShapes<1>(monomorphic, callIndex++)); });
+	Run("CallSite/4-way", [&]() { DoNotOptimize(CallShapes<4>(polymorphic, callIndex++)); });
+	Run("CallSite/megamorphic", [&]() { DoNotOptimize(CallShapes<8>(megamorphic, callIndex++)); });
+	Run("GetMethod+Invoke/monomorphic", [&]() { DoNotOptimize(CallShapesByName<1>(callIndex++)); });
+	Run("GetMethod+Invoke/4-way", [&]() { DoNotOptimize(CallShapesByName<4>(callIndex++)); });
+	Run("GetMethod+Invoke/megamorphic", [&]() { DoNotOptimize(CallShapesByName<8>(callIndex++)); });
+
+	// Results returned in an Any vs constructed in the caller's storage
+	Camera camera;
+	const meta::Method* getName = meta::Get<Camera>()->GetMethod("GetName");
+	const meta::Method* getView = meta::Get<Camera>()->GetMethod("GetView");
+	Run("Invoke/string", [&]() { DoNotOptimize(meta::Invoke(getName, camera).cast<std::string>().size()); });
+	Run("InvokeInto/string", [&]() 
+	{ 
+		alignas(std::string) unsigned char slot[sizeof(std::string)];
+		std::string* name = reinterpret_cast<std::string*>(slot);
+		meta::InvokeInto(name, getName, camera);
+		DoNotOptimize(name->size());
+		name->~basic_string();
+	});
+	Run("Invoke/matrix", [&]() { DoNotOptimize(meta::Invoke(getView, camera).cast<Matrix>().m[0]); });
+	Run("InvokeInto/matrix", [&]() { Matrix view; meta::InvokeInto(&view, getView, camera); DoNotOptimize(view.m[0]); });
+
+	// A 200 step getter, computed every call vs memoized
+	const meta::Method* expensive = type->GetMethod("Expensive");
+	const meta::Method* expensivePure = type->GetMethod("ExpensivePure");
+	Run("Invoke/getter", [&]() { DoNotOptimize(meta::Invoke(expensive, target, 200)); });
+	Run("Invoke/getter/memoized", [&]() { DoNotOptimize(meta::Invoke(expensivePure, target, 200)); });
+
+#if META_INSTRUMENTATION
+	// Same call with counters and histograms recording (compiled in, runtime enabled)
+	meta::instrumentation::SetEnabled(true);
+	Run("Invoke/1/instrumented", [&]() { DoNotOptimize(meta::Invoke(methods[1], target, 1)); });
+	meta::instrumentation::SetEnabled(false);
+#endif
+
+	// Any, small (in place) and large (heap) payloads
+	int smallValue = 42;
+	Large largeValue = {};
+	Any smallAny(smallValue);
+	Any largeAny(largeValue);
+
+	Run("Any/construct/small", [&]() { Any a(smallValue); DoNotOptimize(a); });
+	Run("Any/construct/large", [&]() { Any a(largeValue); DoNotOptimize(a); });
+	Run("Any/copy/small", [&]() { Any a(smallAny); DoNotOptimize(a); });
+	Run("Any/copy/large", [&]() { Any a(largeAny); DoNotOptimize(a); });
+	Any sharedAny(largeValue);
+	sharedAny.share();
+	Run("Any/copy/large/shared", [&]() { Any a(sharedAny); DoNotOptimize(a); });
+	Run("Any/cast/small", [&]() { DoNotOptimize(smallAny.cast<int>()); });
+	Run("Any/cast/large", [&]() { DoNotOptimize(largeAny.cast<Large>().values[0]); });
+
+	// Instance creation, pooled vs new
+	const meta::TypeData* targetType = meta::Get_Name("ReflectionBench::Target");
+	Run("Create/Destroy", [&]() { void* instance = targetType->Create(); DoNotOptimize(instance); targetType->Destroy(instance); });
+	Run("new/delete", [&]() { Target* instance = new Target(); DoNotOptimize(instance); delete instance; });
+
+	// Bulk lifecycle, 1024 elements. int takes the memcpy path, Target the per-type loop.
+	const meta::TypeData* intType = meta::Get<int>();
+	std::vector<int> ints(1024), intCopies(1024);
+	Run("CopyArray/1024/trivial", [&]() { intType->CopyArray(intCopies.data(), ints.data(), 1024); DoNotOptimize(intCopies[0]); });
+
+	std::vector<Target> targets(1024);
+	Target* targetCopies = static_cast<Target*>(::operator new(sizeof(Target) * 1024));
+	Run("CopyArray/1024", [&]() 
+	{ 
+		targetType->CopyArray(targetCopies, targets.data(), 1024); 
+		DoNotOptimize(targetCopies[0].a); 
+		targetType->DestroyArray(targetCopies, 1024); 
+	});
+	::operator delete(targetCopies);
+
+	// Member columns, 1024 elements
+	meta::Column<float> column(targets, targetType->GetMember("b"));
+	std::vector<float> packed(1024);
+	Run("Column/gather/1024", [&]() { column.Gather(packed.data()); DoNotOptimize(packed[0]); });
+	Run("Column/scatter/1024", [&]() { column.Scatter(packed.data()); DoNotOptimize(targets[0].b); });
+
+	// Filtering 64K objects on two members, unpredictable outcomes
+	std::vector<Target> records(1 << 16);
+	for(size_t i = 0; i < records.size(); ++i)
+	{
+		records[i].a = (int)((i * 2654435761u) >> 7) % 100;
+		records[i].b = (float)((i * 40503u) % 100);
+	}
+	Run("Query/count/64K", [&]() { DoNotOptimize(meta::Query(records).Where("a", meta::Greater, 50).Where("b", meta::Less, 25.0f).Count()); });
+	Run("loop/count/64K", [&]() 
+	{
+		size_t count = 0;
+		for(const Target& record : records)
+		{
+			if(record.a > 50 && record.b < 25.0f)
+			{
+				++count;
+			}
+		}
+		DoNotOptimize(count);
+	});
+
+	const size_t unsortedCount = 1 << 14;
+
+	// Hashing, one object and a batch of 16K
+	Run("Hash", [&]() { DoNotOptimize(meta::Hash(target)); });
+	std::vector<uint64_t> hashes(unsortedCount);
+	Run("HashBatch/16K", [&]() { meta::HashBatch(targetType, records.data(), unsortedCount, hashes.data()); DoNotOptimize(hashes[0]); });
+
+	// Sorting 16K objects by a member chosen at runtime. Both include restoring the unsorted input.
+	std::vector<Target> unsorted(records.begin(), records.begin() + unsortedCount);
+	std::vector<Target> sorting;
+	const meta::Member* sortMember = targetType->GetMember("b");
+	Run("SortBy/16K", [&]() { sorting = unsorted; meta::SortBy(sorting, sortMember); DoNotOptimize(sorting[0].b); });
+	Run("std::sort/16K", [&]() 
+	{ 
+		sorting = unsorted; 
+		std::sort(sorting.begin(), sorting.end(), [&](const Target& x, const Target& y) 
+		{ 
+			const meta::Member* member = targetType->GetMember("b");
+			return *static_cast<const float*>(member->GetPointer(&x)) < *static_cast<const float*>(member->GetPointer(&y)); 
+		}); 
+		DoNotOptimize(sorting[0].b); 
+	});
+
+	// Migrating 16K saved records: a reorder, a widening and a default
+	meta::Schema savedSchema = meta::Schema::Of(meta::Get<TargetV1>());
+	std::vector<TargetV1> saved(unsortedCount, TargetV1{ 2.0f, 1 });
+	Target* migrated = static_cast<Target*>(::operator new(sizeof(Target) * unsortedCount));
+	Run("Migrate/16K", [&]() { meta::Migrate(savedSchema, saved.data(), unsortedCount, migrated); DoNotOptimize(migrated[0].a); });
+	::operator delete(migrated);
+
+	// Logging a 64 byte POD and a polymorphic object (three fields), against formatting the latter in place. The log
+	// cases drain the buffer when it fills, on the logging thread, so include the amortized drain.
+	std::ostream discarded(nullptr);
+	Matrix logged = {};
+	auto logOrDrain = [&](const auto& object) 
+	{ 
+		if(!meta::logging::Log(object)) 
+		{ 
+			meta::logging::DrainBinary(discarded); 
+			meta::logging::Log(object); 
+		} 
+	};
+	Run("Log/pod", [&]() { logOrDrain(logged); });
+	Run("Log/fields", [&]() { logOrDrain(target); });
+	Run("snprintf/fields", [&]() 
+	{ 
+		char line[128]; 
+		std::snprintf(line, sizeof(line), "Target { a = %d, b = %g, c = %g }", target.a, target.b, target.c); 
+		DoNotOptimize(line[0]); 
+	});
+
+	// An undoable edit of one float member, journaled against snapshotting the whole (128 byte) object
+	meta::Journal journal;
+	const meta::Member* journaled = targetType->GetMember("b");
+	float edit = 0.0f;
+	Run("Journal/write+commit", [&]() 
+	{ 
+		journal.Write(&target, journaled, edit += 1.0f); 
+		journal.Commit(); 
+		if(journal.GetStepCount() == (1 << 16))
+		{
+			journal.Clear();
+		}
+	});
+	std::vector<Large> snapshots;
+	snapshots.reserve(1 << 16);
+	Run("snapshot/128B", [&]() 
+	{ 
+		snapshots.push_back(largeValue); 
+		if(snapshots.size() == (1 << 16))
+		{
+			snapshots.clear();
+		}
+	});
+
+	std::printf("\n]\n");
+	return 0;
+}
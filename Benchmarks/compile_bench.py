@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+"""Compile-time benchmark for the reflection headers.
+
+Generates a synthetic translation unit with hundreds of reflected types and
+methods (arity 0-8), compiles it against the headers in CPP_Reflection/, and
+reports compile time and object size. With --baseline, the same unit is also
+compiled against the headers at a git revision, for a before/after comparison.
+With --size-report, the reflection code and data in each object (symbols in
+meta:: and anyimpl::, and the registration statics) are attributed to the
+registered type they were instantiated for. The rest is reported as shared
+thunks (call, Any, conversion and lifecycle templates instantiated for
+signatures and built-in types) or as registry and runtime code (the rest of
+the library). --object runs the same report on existing objects or binaries,
+whose registered types are found by their s_TypeData symbols, instead of the
+synthetic unit.
+
+    python3 Benchmarks/compile_bench.py --baseline HEAD~1 --size-report
+    python3 Benchmarks/compile_bench.py --object build/CPP_Reflection/CPP_Reflection
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCE_DIR = os.path.join(REPO_ROOT, "CPP_Reflection")
+
+PRIMITIVES = ["int", "float", "char", "double"]
+
+
+def generate_source(type_count, methods_per_type):
+    lines = ['#include "Meta.h"', "", "namespace compile_bench", "{"]
+
+    for t in range(type_count):
+        name = "Type%d" % t
+        lines.append("\tclass %s" % name)
+        lines.append("\t{")
+        lines.append("\tpublic:")
+        for m, prim in enumerate(PRIMITIVES):
+            lines.append("\t\t%s m%d;" % (prim, m))
+        for m in range(methods_per_type):
+            arity = m % 9
+            params = ", ".join("%s p%d" % (PRIMITIVES[(t + m + i) % 4], i) for i in range(arity))
+            ret = PRIMITIVES[(t + m) % 4]
+            const = " const" if m % 2 else ""
+            body = " + ".join(["m0"] + ["p%d" % i for i in range(arity)])
+            lines.append("\t\t%s f%d(%s)%s { return (%s)(%s); }" % (ret, m, params, const, ret, body))
+        lines.append("\t\tmeta_declare(%s);" % name)
+        lines.append("\t};")
+        lines.append("")
+        lines.append("\tmeta_define(%s)" % name)
+        for m in range(len(PRIMITIVES)):
+            lines.append('\t\t.member("m%d", &%s::m%d)' % (m, name, m))
+        for m in range(methods_per_type):
+            lines.append('\t\t.method("f%d", &%s::f%d)' % (m, name, m))
+        lines.append("\t\t.finish();")
+        lines.append("")
+
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+def section_sizes(obj_path):
+    """text/data/bss from `size`, when binutils is available."""
+    try:
+        out = subprocess.run(["size", obj_path], capture_output=True, text=True, check=True).stdout
+        text, data, bss = (int(v) for v in out.splitlines()[1].split()[:3])
+        return {"text": text, "data": data, "bss": bss}
+    except (OSError, subprocess.CalledProcessError, IndexError, ValueError):
+        return {}
+
+
+# Registered types, by the TypeData their registration defines (meta_declare() and meta_declare_primitive()).
+REGISTERED_TYPE = [re.compile(r"^(.+)::TypeDataStaticHolder::s_TypeData$"),
+                   re.compile(r"^meta::internal::TypeDataHolder<(.+)>::s_TypeData$")]
+
+# Built-in types are registered by the library itself, so their symbols count as shared.
+BUILTIN_TYPE = re.compile(r"^(void|bool|wchar_t|char(16|32)_t|float|(long )?double|std::nullptr_t|"
+                          r"((un)?signed )?(char|short|int|long|long long)( int)?|unsigned)$")
+
+# Code generated for reflection, as opposed to the program's own.
+REFLECTION_SYMBOL = re.compile(r"\bmeta::|\banyimpl::|::TypeDataStaticHolder::|::GetType\(\) const$|"
+                               r"^__static_initialization_and_destruction_0|^_GLOBAL__sub_I_")
+
+NM_LINE = re.compile(r"^([0-9a-fA-F]+) ([0-9a-fA-F]+) \S (.+)$")
+
+
+def read_symbols(obj_path):
+    """(size, demangled name) of every defined symbol with a size, from `nm`."""
+    out = subprocess.run(["nm", "-C", "--print-size", "--defined-only", obj_path],
+                         capture_output=True, text=True, check=True).stdout
+
+    symbols = set()
+    member = ""
+    for line in out.splitlines():
+        if line.endswith(":"):
+            member = line  # an archive's next object
+            continue
+        match = NM_LINE.match(line)
+        if match:
+            # aliases (complete and base object constructors) demangle to the same name at the same address, and count once
+            symbols.add((member, match.group(1), int(match.group(2), 16), match.group(3)))
+    return [(size, name) for _, _, size, name in symbols]
+
+
+def without_parameters(name):
+    """A demangled name without its functions' parameter lists (its own, and those of the functions its lambdas and
+    local classes are in), so taking a type, like a std::string, isn't naming it."""
+    out = []
+    skip = 0
+    for i, c in enumerate(name):
+        if skip:
+            skip += {"(": 1, ")": -1}.get(c, 0)
+        elif c == "(" and i and (name[i - 1].isalnum() or name[i - 1] in "_>"):
+            skip = 1
+        else:
+            out.append(c)
+    return "".join(out)
+
+
+def symbol_sizes(obj_path):
+    """Reflection bytes per registered type, shared thunk and registry bytes, and the total, from `nm`."""
+    try:
+        symbols = read_symbols(obj_path)
+    except (OSError, subprocess.CalledProcessError):
+        return {}
+
+    types = set()
+    for _, name in symbols:
+        for pattern in REGISTERED_TYPE:
+            match = pattern.match(name)
+            if match and not BUILTIN_TYPE.match(match.group(1).strip()):
+                types.add(match.group(1).strip())
+
+    # A symbol naming several types goes to the first one named, preferring the program's types to std:: ones
+    # (MemoizedMethod<std::string (Grid::*)()> is Grid's). Longest names first, so MetaTest::Other::A1 isn't A1.
+    type_names = []
+    for group in ([t for t in types if not t.startswith("std::")], [t for t in types if t.startswith("std::")]):
+        if group:
+            alternatives = "|".join(re.escape(t) for t in sorted(group, key=len, reverse=True))
+            type_names.append(re.compile(r"(?<![\w:])(%s)(?!\w)" % alternatives))
+
+    per_type = dict.fromkeys(types, 0)
+    thunks = registry = other = 0
+    for size, name in symbols:
+        if not REFLECTION_SYMBOL.search(name):
+            other += size
+            continue
+        scope = without_parameters(name)
+        match = next((m for m in (pattern.search(scope) for pattern in type_names) if m), None)
+        if match:
+            per_type[match.group(1)] += size
+        elif "<" in name:
+            # a template instantiated for signatures and value types rather than for a registered type
+            thunks += size
+        else:
+            registry += size
+
+    sizes = list(per_type.values())
+    reflection = sum(sizes) + thunks + registry
+    return {
+        "types": len(sizes),
+        "per_type": per_type,
+        "per_type_avg": sum(sizes) / float(len(sizes)) if sizes else 0.0,
+        "per_type_min": min(sizes) if sizes else 0,
+        "per_type_max": max(sizes) if sizes else 0,
+        "per_type_bytes": sum(sizes),
+        "thunk_bytes": thunks,
+        "registry_bytes": registry,
+        "reflection_bytes": reflection,
+        "symbol_bytes": reflection + other,
+    }
+
+
+def compile_once(cxx, flags, include_dir, source_path, obj_path):
+    cmd = [cxx] + flags + ["-I", include_dir, "-c", source_path, "-o", obj_path]
+    start = time.perf_counter()
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    elapsed = time.perf_counter() - start
+    if result.returncode != 0:
+        sys.stderr.write(result.stderr[-4000:])
+        raise SystemExit("compile failed against %s" % include_dir)
+    return elapsed
+
+
+def measure(label, cxx, flags, include_dir, source_path, work_dir, repeat, size_report=False):
+    obj_path = os.path.join(work_dir, label + ".o")
+    times = [compile_once(cxx, flags, include_dir, source_path, obj_path) for _ in range(repeat)]
+    report = {
+        "label": label,
+        "compile_seconds": min(times),
+        "object_bytes": os.path.getsize(obj_path),
+    }
+    report.update(section_sizes(obj_path))
+    if size_report:
+        report["symbols"] = symbol_sizes(obj_path)
+    return report
+
+
+def print_size_report(results, top):
+    width = max([10] + [len(r["label"]) + 1 for r in results])
+    print("%-*s %6s %12s %8s %8s %12s %12s %12s %14s %8s" % (width, "", "types", "per type avg", "min", "max",
+                                                            "per type sum", "thunks", "registry", "reflection", "of all"))
+    for r in results:
+        s = r.get("symbols")
+        if not s:
+            print("%-*s (nm not available)" % (width, r["label"]))
+            continue
+        print("%-*s %6d %12.0f %8d %8d %12d %12d %12d %14d %7.1f%%" % (
+            width, r["label"], s["types"], s["per_type_avg"], s["per_type_min"], s["per_type_max"],
+            s["per_type_bytes"], s["thunk_bytes"], s["registry_bytes"], s["reflection_bytes"],
+            100.0 * s["reflection_bytes"] / s["symbol_bytes"] if s["symbol_bytes"] else 0.0))
+
+    for r in results:
+        s = r.get("symbols")
+        if not s or not s["per_type"] or not top:
+            continue
+        print()
+        print("%s, largest types:" % r["label"])
+        for name, size in sorted(s["per_type"].items(), key=lambda item: (-item[1], item[0]))[:top]:
+            print("  %10d  %s" % (size, name))
+
+
+def export_revision(revision, dest):
+    """Extracts CPP_Reflection/ at a git revision into dest."""
+    archive = subprocess.run(["git", "-C", REPO_ROOT, "archive", revision, "CPP_Reflection"],
+                             capture_output=True, check=True).stdout
+    subprocess.run(["tar", "-x", "-C", dest], input=archive, check=True)
+    return os.path.join(dest, "CPP_Reflection")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--types", type=int, default=200, help="number of reflected types")
+    parser.add_argument("--methods", type=int, default=9, help="reflected methods per type (arity cycles 0-8)")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--flags", default="-std=c++17 -O2", help="compiler flags")
+    parser.add_argument("--include-dir", default=SOURCE_DIR, help="headers under test")
+    parser.add_argument("--baseline", help="git revision to compare against")
+    parser.add_argument("--repeat", type=int, default=1, help="compiles per configuration, fastest is reported")
+    parser.add_argument("--size-report", action="store_true", help="attribute symbol sizes to the registered types")
+    parser.add_argument("--object", action="append", help="size-report this object or binary instead (repeatable)")
+    parser.add_argument("--top", type=int, default=10, help="largest types listed by the size report")
+    parser.add_argument("--json", help="also write the results to this file")
+    args = parser.parse_args()
+
+    if args.object:
+        results = [dict(label=os.path.basename(path), path=path, symbols=symbol_sizes(path)) for path in args.object]
+        print_size_report(results, args.top)
+        if args.json:
+            with open(args.json, "w") as f:
+                json.dump({"results": results}, f, indent=2)
+        return
+
+    work_dir = tempfile.mkdtemp(prefix="meta_compile_bench_")
+    try:
+        source_path = os.path.join(work_dir, "synthetic_reflection.cpp")
+        with open(source_path, "w") as f:
+            f.write(generate_source(args.types, args.methods))
+
+        flags = args.flags.split()
+        results = []
+        if args.baseline:
+            baseline_dir = export_revision(args.baseline, work_dir)
+            results.append(measure("baseline", args.cxx, flags, baseline_dir, source_path, work_dir, args.repeat,
+                                   args.size_report))
+        results.append(measure("current", args.cxx, flags, args.include_dir, source_path, work_dir, args.repeat,
+                               args.size_report))
+
+        print("%d types, %d methods each, %s %s" % (args.types, args.methods, args.cxx, args.flags))
+        print("%-10s %12s %14s %12s" % ("", "compile (s)", "object (bytes)", "text (bytes)"))
+        for r in results:
+            print("%-10s %12.2f %14d %12s" % (r["label"], r["compile_seconds"], r["object_bytes"], r.get("text", "-")))
+
+        if args.size_report:
+            print()
+            print_size_report(results, args.top)
+
+        if args.json:
+            with open(args.json, "w") as f:
+                json.dump({"types": args.types, "methods": args.methods, "results": results}, f, indent=2)
+    finally:
+        shutil.rmtree(work_dir, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -2,6 +2,8 @@
 
 //original from http://www.codeproject.com/Articles/11250/High-Performance-Dynamic-Typing-in-C-using-a-Repla
 
+#include <atomic>
+#include <cstdint>
 #include <type_traits>
 #include <utility>
 #include <typeinfo>
@@ -11,42 +13,83 @@
 namespace anyimpl
 {
 	struct bad_any_cast {};
+	struct bad_any_copy {};
 	struct empty_any {};
 
 	struct base_any_policy
 	{
 		virtual void static_delete(void** x) = 0;
 		virtual void copy_from_value(void const* src, void** dest) = 0;
+		virtual void move_from_value(void* src, void** dest) = 0;
 		virtual void clone(void* const* src, void** dest) = 0;
 		virtual void move(void* const* src, void** dest) = 0;
 		virtual void* get_value(void** src) = 0;
 		virtual size_t get_size() = 0;
+		virtual bool is_trivially_copyable() = 0;
+
+		/// Copy-on-write support. get_value() hands out a payload that isn't shared with another Any,
+		/// const_value() reads it in place. Policies that can't share return false from share().
+		virtual bool share(void** /*x*/) { return false; }
+		virtual bool is_shared(void* const* /*x*/) { return false; }
+		virtual const void* const_value(void* const* src) { return get_value(const_cast<void**>(src)); }
 	};
 
 	template<typename T>
 	struct typed_base_any_policy : base_any_policy
 	{
 		virtual size_t get_size() { return sizeof(T); }
+		virtual bool is_trivially_copyable() { return std::is_trivially_copyable<T>::value; }
 	};
 
+	//Copies into a new heap object. Move-only types can be stored, but throw on copy.
+	template<typename T>
+	T* copy_new(const T& src, std::true_type) { return new T(src); }
+
+	template<typename T>
+	T* copy_new(const T& /*src*/, std::false_type) { throw bad_any_copy(); }
+
 	//This policy is for small, primitive, nonclass types to store the information.
 	template<typename T>
 	struct small_any_policy : typed_base_any_policy<T>
 	{
 		virtual void static_delete(void** x) {}
 		virtual void copy_from_value(void const* src, void** dest){ new (dest) T(*reinterpret_cast<T const*>(src));}
+		virtual void move_from_value(void* src, void** dest){ new (dest) T(std::move(*reinterpret_cast<T*>(src)));}
 		virtual void clone(void* const* src, void** dest) { *dest = *src; }
 		virtual void move(void* const* src, void** dest)  { *dest = *src; }
 		virtual void* get_value(void** src) { return reinterpret_cast<void*>(src); }
 	};
 
+	//A large payload shared by several anys: copies bump m_refs, the last one out deletes it.
+	template<typename T>
+	struct shared_payload
+	{
+		std::atomic<size_t> m_refs;
+		T m_value;
+	};
+
 	//This policy is for large, class types to store the information.
+	//The object is either a T*, or a shared_payload<T>* tagged with the low bit.
 	template<typename T>
 	struct big_any_policy : typed_base_any_policy<T>
 	{
+		static bool tagged(void* const* x) { return (reinterpret_cast<uintptr_t>(*x) & 1) != 0; }
+
+		static shared_payload<T>* payload(void* const* x) 
+		{ 
+			return reinterpret_cast<shared_payload<T>*>(reinterpret_cast<uintptr_t>(*x) & ~uintptr_t(1)); 
+		}
+
 		virtual void static_delete(void** x) 
 		{
-			if(*x)
+			if(*x && tagged(x))
+			{
+				if(payload(x)->m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					delete payload(x);
+				}
+			}
+			else if(*x)
 			{
 				delete(*reinterpret_cast<T**>(x));
 			}
@@ -55,24 +98,68 @@ namespace anyimpl
 
 		virtual void copy_from_value(void const* src, void** dest)
 		{ 
-			*dest = new T(*reinterpret_cast<T const*>(src));
+			*dest = copy_new(*reinterpret_cast<T const*>(src), std::is_copy_constructible<T>());
+		}
+
+		virtual void move_from_value(void* src, void** dest)
+		{ 
+			*dest = new T(std::move(*reinterpret_cast<T*>(src)));
 		}
 
 		virtual void clone(void* const* src, void** dest) 
 		{ 
-			*dest = new T(**reinterpret_cast<T* const*>(src));
+			if(tagged(src))
+			{
+				payload(src)->m_refs.fetch_add(1, std::memory_order_relaxed);
+				*dest = *src;
+				return;
+			}
+			*dest = copy_new(**reinterpret_cast<T* const*>(src), std::is_copy_constructible<T>());
 		}
 
 		virtual void move(void* const* src, void** dest)  
 		{ 
-			(*reinterpret_cast<T**>(dest))->~T(); 
-			**reinterpret_cast<T**>(dest) = **reinterpret_cast<T* const*>(src);
+			*reinterpret_cast<T*>(get_value(dest)) = std::move(*reinterpret_cast<T*>(get_value(const_cast<void**>(src))));
 		}
 
+		// Detaches a shared payload first, copying it if another any still refers to it.
 		virtual void* get_value(void** src) 
 		{ 
-			return *src;
+			if(!tagged(src))
+			{
+				return *src;
+			}
+
+			shared_payload<T>* shared = payload(src);
+			if(shared->m_refs.load(std::memory_order_acquire) == 1)
+			{
+				return &shared->m_value;
+			}
+
+			T* copy = copy_new(shared->m_value, std::is_copy_constructible<T>());
+			static_delete(src);
+			*src = copy;
+			return copy;
+		}
+
+		virtual const void* const_value(void* const* src)
+		{
+			return tagged(src) ? &payload(src)->m_value : *src;
 		}
+
+		virtual bool share(void** x)
+		{
+			if(*x && !tagged(x))
+			{
+				T* value = *reinterpret_cast<T**>(x);
+				shared_payload<T>* shared = new shared_payload<T>{ { 1 }, std::move(*value) };
+				delete value;
+				*x = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(shared) | 1);
+			}
+			return true;
+		}
+
+		virtual bool is_shared(void* const* x) { return *x && tagged(x); }
 	};
 
 	template<typename T>
@@ -136,12 +223,20 @@ private:
 	anyimpl::base_any_policy* policy;
 	void* object;
 
+	/// Excludes Any itself and arrays (c-strings go through the const char* overloads) from the forwarding overloads.
+	template<typename T>
+	struct is_value : std::integral_constant<bool, 
+		!std::is_same<typename std::decay<T>::type, Any>::value && 
+		!std::is_array<typename std::remove_reference<T>::type>::value>
+	{};
+
 public:
 
-	template<typename T>
-	Any(const T& x) : policy(anyimpl::get_policy<anyimpl::empty_any>()), object(NULL)
+	/// Stores a copy of x, or moves x in when given an rvalue.
+	template<typename T, typename = typename std::enable_if<is_value<T>::value>::type>
+	Any(T&& x) : policy(anyimpl::get_policy<anyimpl::empty_any>()), object(NULL)
 	{
-		assign(x);
+		assign(std::forward<T>(x));
 	}
 
 	Any() : policy(anyimpl::get_policy<anyimpl::empty_any>()), object(NULL)
@@ -157,6 +252,13 @@ public:
 		assign(x);
 	}
 
+	/// Takes over x's payload, leaving x empty.
+	Any(Any&& x) : policy(x.policy), object(x.object)
+	{
+		x.policy = anyimpl::get_policy<anyimpl::empty_any>();
+		x.object = NULL;
+	}
+
 	/// Destructor. 
     ~Any() 
 	{
@@ -172,21 +274,41 @@ public:
         return *this;
     }
 
-	 /// Assignment function. 
+	 /// Assignment function. Copies lvalues, moves rvalues.
     template <typename T>
-    Any& assign(const T& x) 
+    typename std::enable_if<is_value<T>::value, Any&>::type assign(T&& x) 
 	{
+		typedef typename std::decay<T>::type StoredT;
+
         reset();
-        policy = anyimpl::get_policy<T>();
-        policy->copy_from_value(&x, &object);
+        policy = anyimpl::get_policy<StoredT>();
+		if(std::is_lvalue_reference<T>::value || std::is_const<typename std::remove_reference<T>::type>::value)
+		{
+			policy->copy_from_value(&x, &object);
+		}
+		else
+		{
+			policy->move_from_value(const_cast<StoredT*>(&x), &object);
+		}
         return *this;
     }
 
-	/// Assignment operator.
+	/// Assignment operators.
+	Any& operator=(const Any& x)
+	{
+		return assign(x);
+	}
+
+	Any& operator=(Any&& x)
+	{
+		Any(std::move(x)).swap(*this);
+		return *this;
+	}
+
     template<typename T>
-    Any& operator=(const T& x) 
+    typename std::enable_if<is_value<T>::value, Any&>::type operator=(T&& x) 
 	{
-        return assign(x);
+        return assign(std::forward<T>(x));
     }
 
 	/// Assignment operator, specialized for c-strings.
@@ -216,6 +338,24 @@ public:
         return *r;
     }
 
+	/// Returns true if the any holds exactly a T.
+	template<typename T>
+	bool is() const
+	{
+		return policy == anyimpl::get_policy<T>();
+	}
+
+	/// Read access that never copies a shared payload.
+	template<typename T>
+	const T& cast() const
+	{
+		if(policy != anyimpl::get_policy<T>())
+		{
+			throw anyimpl::bad_any_cast();
+		}
+		return *reinterpret_cast<const T*>(policy->const_value(&object));
+	}
+
 	template<typename T>
     T* getPointer() 
 	{
@@ -227,6 +367,44 @@ public:
         return r;
     }
 
+	/// Untyped access to the stored value, and its size. For tools that only copy bytes (tracing, logging).
+	void* getRawPointer()
+	{
+		return policy->get_value(&object);
+	}
+
+	const void* getRawPointer() const
+	{
+		return policy->const_value(&object);
+	}
+
+	size_t getSize() const
+	{
+		return policy->get_size();
+	}
+
+	/// Whether the stored value's bytes are its value, so getRawPointer() can be copied.
+	bool isTriviallyCopyable() const
+	{
+		return policy->is_trivially_copyable();
+	}
+
+	/// Copy-on-write mode, for large values that are copied a lot and rarely changed. Copies of a shared any
+	/// refer to one refcounted payload; cast(), getPointer() and the other mutable accessors copy it out first
+	/// if it's still shared. Small values are always copied in place, and stay that way. Reflected calls read
+	/// const T& arguments and receivers of const methods in place, so they don't copy a shared payload.
+	Any& share()
+	{
+		policy->share(&object);
+		return *this;
+	}
+
+	/// True while the payload is in shared mode (even when this is its last owner).
+	bool shared() const
+	{
+		return policy->is_shared(&object);
+	}
+
 	/// Returns true if the any contains no value. 
     bool empty() const 
 	{
@@ -239,6 +417,12 @@ public:
         policy = anyimpl::get_policy<anyimpl::empty_any>();
     }
 
+	/// Identifies the stored type: anys holding the same type share a policy.
+	const anyimpl::base_any_policy* getPolicy() const
+	{
+		return policy;
+	}
+
 	 /// Returns true if the two types are the same. 
     bool compatible(const Any& x) const 
 	{
@@ -249,7 +433,13 @@ public:
 template <typename Type> 
 struct make_any
 {
-	static Any make(Type value) { return Any(value); }
+	static Any make(Type value) { return Any(std::move(value)); }
+};
+
+template <typename Type> 
+struct make_any<Type&&>
+{
+	static Any make(Type&& value) { return Any(std::move(value)); }
 };
 
 template <typename Type> 
@@ -1,5 +1,7 @@
 #include "AnyTest.h"
 #include <iostream>
+#include <vector>
+#include <assert.h>
 
 namespace AnyTest
 {
@@ -35,4 +37,44 @@ namespace AnyTest
 		a = "Hello";
 		const char* output = a.cast<const char*>();
 	}
+
+	// Copy-on-write payloads
+	void SharedTest()
+	{
+		std::string text(1000, 'x');
+		Any original(text);
+		assert(!original.shared());
+		original.share();
+		assert(original.shared() && original.cast<std::string>() == text);
+
+		// Copies share the payload
+		std::vector<Any> listeners(8, original);
+		const Any& listener = listeners[3];
+		assert(listener.shared() && &listener.cast<std::string>() == &static_cast<const Any&>(original).cast<std::string>());
+
+		// Writing through one copy detaches it, the others still see the old value
+		listeners[3].cast<std::string>() = "changed";
+		assert(!listeners[3].shared() && listeners[3].cast<std::string>() == "changed");
+		assert(static_cast<const Any&>(listeners[4]).cast<std::string>() == text);
+		assert(static_cast<const Any&>(original).cast<std::string>() == text);
+
+		// The last owner writes in place
+		Any last(std::string("solo"));
+		last.share();
+		const std::string* before = &static_cast<const Any&>(last).cast<std::string>();
+		last.cast<std::string>() += "!";
+		assert(&last.cast<std::string>() == before && last.cast<std::string>() == "solo!");
+
+		// Small values are unaffected
+		Any small(7);
+		small.share();
+		Any smallCopy(small);
+		smallCopy.cast<int>() = 8;
+		assert(!small.shared() && small.cast<int>() == 7);
+
+		listeners.clear();
+		assert(original.cast<std::string>() == text);
+
+		std::cout << "Any shared: ok" << std::endl;
+	}
 }
@@ -3,4 +3,5 @@
 namespace AnyTest
 {
 	void BasicTest();
+	void SharedTest();
 }
@@ -0,0 +1,179 @@
+#include "ArchetypeTest.h"
+#include "MetaArchetype.h"
+#include <iostream>
+#include <stdexcept>
+#include <assert.h>
+
+namespace ArchetypeTest
+{
+	struct Position
+	{
+		float x, y, z;
+	};
+
+	struct Velocity
+	{
+		float dx, dy, dz;
+		int frames;
+	};
+
+	// Counts live instances; copy assignment throws on request, and copy construction once s_copiesLeft runs out
+	struct Tracked
+	{
+		static int s_live;
+		static bool s_throwOnAssign;
+		static int s_copiesLeft;
+		int value;
+
+		Tracked() : value(0) { ++s_live; }
+		~Tracked() { --s_live; }
+
+		Tracked(const Tracked& rhs) : value(rhs.value)
+		{
+			if(s_copiesLeft-- == 0)
+			{
+				throw std::runtime_error("Tracked, copy failed");
+			}
+			++s_live;
+		}
+
+		Tracked& operator=(const Tracked& rhs)
+		{
+			if(s_throwOnAssign)
+			{
+				throw std::runtime_error("Tracked, assignment failed");
+			}
+			value = rhs.value;
+			return *this;
+		}
+	};
+
+	int Tracked::s_live = 0;
+	bool Tracked::s_throwOnAssign = false;
+	int Tracked::s_copiesLeft = -1;
+
+	struct Labelled
+	{
+		Tracked label;
+		Tracked tag;
+	};
+}
+
+meta_declare_primitive(ArchetypeTest::Tracked);
+
+meta_declare_primitive(ArchetypeTest::Labelled)
+	.member("label", &ArchetypeTest::Labelled::label)
+	.member("tag", &ArchetypeTest::Labelled::tag)
+	.finish();
+
+meta_declare_primitive(ArchetypeTest::Position)
+	.member("x", &ArchetypeTest::Position::x)
+	.member("y", &ArchetypeTest::Position::y)
+	.member("z", &ArchetypeTest::Position::z)
+	.finish();
+
+meta_declare_primitive(ArchetypeTest::Velocity)
+	.member("dx", &ArchetypeTest::Velocity::dx)
+	.member("dy", &ArchetypeTest::Velocity::dy)
+	.member("dz", &ArchetypeTest::Velocity::dz)
+	.member("frames", &ArchetypeTest::Velocity::frames)
+	.finish();
+
+namespace ArchetypeTest
+{
+	void BasicTest()
+	{
+		const meta::TypeData* position = meta::Get<Position>();
+		const meta::TypeData* velocity = meta::Get<Velocity>();
+
+		// small chunks, so rows span several
+		meta::Archetype particles({ position, velocity }, 256);
+		assert(particles.GetColumns().size() == 7 && particles.GetRowsPerChunk() == 256 / 28);
+
+		for(int i = 0; i < 100; ++i)
+		{
+			Position p = { (float)i, 0.0f, 0.0f };
+			Velocity v = { 1.0f, 2.0f, 0.0f, i };
+			assert(particles.Add({ &p, &v }) == (size_t)i);
+		}
+		assert(particles.Size() == 100 && particles.GetChunkCount() == (100 + 8) / 9);
+
+		// one pass per chunk over contiguous columns
+		const meta::Member* x = position->GetMember("x");
+		const meta::Member* dx = velocity->GetMember("dx");
+		for(size_t c = 0; c < particles.GetChunkCount(); ++c)
+		{
+			meta::Archetype::Chunk chunk = particles.GetChunk(c);
+			float* xs = chunk.GetColumn<float>(x);
+			const float* dxs = chunk.GetColumn<float>(dx);
+			for(size_t i = 0; i < chunk.GetRowCount(); ++i)
+			{
+				xs[i] += dxs[i];
+			}
+		}
+
+		Position p = {};
+		particles.Load(42, 0, &p);
+		assert(p.x == 43.0f);
+
+		// the last row moves into the removed one
+		particles.Remove(42);
+		Velocity v = {};
+		particles.Load(42, 1, &v);
+		assert(particles.Size() == 99 && v.frames == 99);
+
+		v.frames = -1;
+		particles.Store(0, 1, &v);
+		assert(*static_cast<int*>(particles.GetValue(0, particles.GetColumnIndex(velocity->GetMember("frames")))) == -1);
+
+		size_t row = particles.Add();
+		particles.Load(row, 0, &p);
+		assert(p.x == 0.0f && p.y == 0.0f);
+
+		// a throwing copy leaves the stored value and the object alive, so each is destroyed once
+		{
+			meta::Archetype labels({ meta::Get<Labelled>() });
+			Labelled labelled;
+			labelled.label.value = 5;
+			labels.Add({ &labelled });
+
+			Tracked::s_throwOnAssign = true;
+			int threw = 0;
+			try { labels.Store(0, 0, &labelled); } catch(const std::runtime_error&) { ++threw; }
+			try { labels.Load(0, 0, &labelled); } catch(const std::runtime_error&) { ++threw; }
+			Tracked::s_throwOnAssign = false;
+			assert(threw == 2 && Tracked::s_live == 4);
+
+			labelled.label.value = 6;
+			labels.Store(0, 0, &labelled);
+			labelled.label.value = 0;
+			labels.Load(0, 0, &labelled);
+			assert(labelled.label.value == 6);
+
+			// a copy that throws while removing a row, in the second column, leaves every row as it was
+			for(int value = 7; value < 9; ++value)
+			{
+				labelled.label.value = value;
+				labelled.tag.value = -value;
+				labels.Add({ &labelled });
+			}
+			Tracked::s_copiesLeft = 2;
+			threw = 0;
+			try { labels.Remove(0); } catch(const std::runtime_error&) { ++threw; }
+			Tracked::s_copiesLeft = -1;
+			assert(threw == 1 && labels.Size() == 3 && Tracked::s_live == 8);
+			for(size_t row = 0; row < 3; ++row)
+			{
+				labels.Load(row, 0, &labelled);
+				assert(labelled.label.value == (row ? 6 + (int)row : 6) && labelled.tag.value == (row ? -6 - (int)row : 0));
+			}
+
+			labels.Remove(0);
+			labels.Load(0, 0, &labelled);
+			assert(labels.Size() == 2 && labelled.label.value == 8 && labelled.tag.value == -8 && Tracked::s_live == 6);
+		}
+		assert(Tracked::s_live == 0);
+
+		std::cout << "Archetype: ok" << std::endl;
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace ArchetypeTest
+{
+	void BasicTest();
+}
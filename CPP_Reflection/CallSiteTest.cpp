@@ -0,0 +1,79 @@
+#include "CallSiteTest.h"
+#include "MetaCallSite.h"
+#include <iostream>
+#include <assert.h>
+
+namespace CallSiteTest
+{
+	#define CALLSITE_SHAPE(NAME, SIDES)										\
+		class NAME															\
+		{																	\
+		public:																\
+			int Sides() const { return SIDES; }								\
+			int Scaled(int scale) const { return SIDES * scale; }			\
+			meta_declare(NAME);												\
+		};																	\
+		meta_define(NAME)													\
+			.method("Sides", &NAME::Sides)									\
+			.method("Scaled", &NAME::Scaled)								\
+			.finish();
+
+	CALLSITE_SHAPE(Triangle, 3)
+	CALLSITE_SHAPE(Square, 4)
+	CALLSITE_SHAPE(Pentagon, 5)
+	CALLSITE_SHAPE(Hexagon, 6)
+	CALLSITE_SHAPE(Heptagon, 7)
+	CALLSITE_SHAPE(Octagon, 8)
+
+	#undef CALLSITE_SHAPE
+
+	class Circle
+	{
+	public:
+		meta_declare(Circle);
+	};
+
+	meta_define(Circle).finish();
+
+	void BasicTest()
+	{
+		meta::CallSite scaled("Scaled");
+		assert(scaled.GetState() == meta::CallSite::Uninitialized);
+
+		Triangle triangle;
+		Square square;
+		Pentagon pentagon;
+		Hexagon hexagon;
+		Heptagon heptagon;
+		Octagon octagon;
+
+		assert(scaled.Call(triangle, 2).cast<int>() == 6);
+		assert(scaled.Call(triangle, 3).cast<int>() == 9);
+		assert(scaled.GetState() == meta::CallSite::Monomorphic);
+		assert(scaled.Resolve(meta::Get<Triangle>()) == meta::Get<Triangle>()->GetMethod("Scaled"));
+
+		assert(scaled.Call(square, 2).cast<int>() == 8);
+		assert(scaled.Call(pentagon, 2).cast<int>() == 10);
+		assert(scaled.Call(hexagon, 2).cast<int>() == 12);
+		assert(scaled.GetState() == meta::CallSite::Polymorphic);
+
+		assert(scaled.Call(heptagon, 2).cast<int>() == 14);
+		assert(scaled.GetState() == meta::CallSite::Megamorphic);
+		assert(scaled.Call(octagon, 2).cast<int>() == 16);
+		assert(scaled.Call(triangle, 2).cast<int>() == 6 && scaled.Call(octagon, 1).cast<int>() == 8);
+
+		// Boxed form
+		meta::CallSite sides("Sides");
+		Any receiver(&square);
+		assert(sides.Call(meta::Get<Square>(), receiver, nullptr).cast<int>() == 4);
+
+		// A type without the method: resolved to null once, and calls throw
+		Circle circle;
+		assert(sides.Resolve(meta::Get<Circle>()) == nullptr);
+		bool threw = false;
+		try { sides.Call(circle); } catch(const std::out_of_range&) { threw = true; }
+		assert(threw);
+
+		std::cout << "CallSite: ok" << std::endl;
+	}
+}
@@ -0,0 +1,155 @@
+#include "CloneTest.h"
+#include "MetaClone.h"
+#include <iostream>
+#include <string>
+#include <assert.h>
+
+namespace CloneTest
+{
+	class Node
+	{
+	public:
+		int value;
+		Node* next;
+		Node* shared;
+		const int* weight;
+		std::string name;	// unreflected, copied by the copy constructor
+
+		Node() : value(0), next(nullptr), shared(nullptr), weight(nullptr) {}
+		virtual ~Node() {}
+
+		meta_declare(Node);
+	};
+
+	meta_define(Node)
+		.member("value", &Node::value)
+		.member("next", &Node::next)
+		.member("shared", &Node::shared)
+		.member("weight", &Node::weight)
+		.finish();
+
+	class Leaf : public Node
+	{
+	public:
+		double extra;
+
+		Leaf() : extra(0.0) {}
+
+		meta_declare(Leaf);
+	};
+
+	meta_define(Leaf)
+		.member("value", static_cast<int Leaf::*>(&Leaf::value))
+		.member("next", static_cast<Node* Leaf::*>(&Leaf::next))
+		.member("shared", static_cast<Node* Leaf::*>(&Leaf::shared))
+		.member("weight", static_cast<const int* Leaf::*>(&Leaf::weight))
+		.member("extra", &Leaf::extra)
+		.finish();
+
+	// Node is a non-primary base, at an offset in the object
+	class Stamp
+	{
+	public:
+		int stamp;
+
+		Stamp() : stamp(0) {}
+		virtual ~Stamp() {}
+	};
+
+	class Stamped : public Stamp, public Node
+	{
+	public:
+		meta_declare(Stamped);
+	};
+
+	meta_define(Stamped)
+		.member("value", static_cast<int Stamped::*>(&Stamped::value))
+		.member("next", static_cast<Node* Stamped::*>(&Stamped::next))
+		.member("stamp", static_cast<int Stamped::*>(&Stamped::stamp))
+		.finish();
+
+	// holds a node by value
+	struct Holder
+	{
+		int id;
+		Node* root;
+		const char* label;
+		void* user;
+	};
+
+	struct Prefab
+	{
+		Holder holder;
+		Node* spare;
+	};
+}
+
+meta_declare_primitive(CloneTest::Holder)
+	.member("id", &CloneTest::Holder::id)
+	.member("root", &CloneTest::Holder::root)
+	.member("label", &CloneTest::Holder::label)
+	.member("user", &CloneTest::Holder::user)
+	.finish();
+
+meta_declare_primitive(CloneTest::Prefab)
+	.member("holder", &CloneTest::Prefab::holder)
+	.member("spare", &CloneTest::Prefab::spare)
+	.finish();
+
+namespace CloneTest
+{
+	void BasicTest()
+	{
+		assert(meta::Get<Node>()->GetMember("next")->GetQualifier() == meta::TypeRecord::Q_Pointer);
+		assert(meta::Get<Node>()->GetMember("next")->GetType() == meta::Get<Node>());
+		assert(meta::Get<Node>()->GetMember("weight")->GetQualifier() == meta::TypeRecord::Q_ConstPointer);
+
+		// a -> b -> c -> a, everything shares b, c is really a Leaf
+		int weight = 5;
+		Node a, b;
+		Leaf c;
+		a.value = 1; b.value = 2; c.value = 3; c.extra = 0.5;
+		a.next = &b; b.next = &c; c.next = &a;
+		a.shared = b.shared = c.shared = &b;
+		a.weight = &weight;
+		c.name = "leaf";
+
+		Prefab prefab = { { 7, &a, "prefab", &weight }, &b };
+
+		meta::Arena arena;
+		Prefab* copy = meta::DeepClone(&prefab, arena);
+
+		Node* a2 = copy->holder.root;
+		assert(copy->holder.id == 7 && a2 != &a && a2->value == 1);
+		assert(a2->next->value == 2 && a2->next != &b && copy->spare == a2->next);
+		assert(a2->next->next->next == a2);
+		assert(a2->shared == a2->next && a2->next->next->shared == a2->next);
+		assert(*a2->weight == 5 && a2->weight != &weight);
+
+		// C strings and void pointers aren't followed
+		assert(copy->holder.label == prefab.holder.label && copy->holder.user == &weight);
+
+		Node* c2 = a2->next->next;
+		assert(c2->GetType() == meta::Get<Leaf>() && static_cast<Leaf*>(c2)->extra == 0.5 && c2->name == "leaf");
+
+		// laid out in the arena in discovery order
+		assert((void*)copy < (void*)a2 && (void*)a2 < (void*)a2->next);
+
+		// a base pointer is cloned as the whole object, and points at the copy's base
+		Node head;
+		Stamped stamped;
+		stamped.stamp = 9; stamped.value = 4;
+		head.next = &stamped;
+		stamped.next = &head;
+		assert((void*)static_cast<Node*>(&stamped) != (void*)&stamped);
+
+		Node* head2 = meta::DeepClone(&head, arena);
+		Stamped* stamped2 = dynamic_cast<Stamped*>(head2->next);
+		assert(stamped2 && stamped2 != &stamped && stamped2->stamp == 9 && stamped2->value == 4 && stamped2->next == head2);
+
+		arena.Reset();
+		assert(arena.GetBytesUsed() == 0);
+
+		std::cout << "Clone: ok" << std::endl;
+	}
+}
@@ -0,0 +1,65 @@
+#include "ColumnTest.h"
+#include "MetaColumn.h"
+#include <iostream>
+#include <assert.h>
+
+namespace ColumnTest
+{
+	struct Record
+	{
+		int id;
+		float value;
+		double weight;
+		char tag;
+	};
+}
+
+meta_declare_primitive(ColumnTest::Record)
+	.member("id", &ColumnTest::Record::id)
+	.member("value", &ColumnTest::Record::value)
+	.member("weight", &ColumnTest::Record::weight)
+	.finish();
+
+namespace ColumnTest
+{
+	void BasicTest()
+	{
+		std::vector<Record> records(37);
+		for(int i = 0; i < 37; ++i)
+		{
+			records[i] = Record{ i, i * 0.5f, i * 2.0, 'r' };
+		}
+
+		const meta::TypeData* type = meta::Get<Record>();
+		meta::Column<float> values(records, type->GetMember("value"));
+		meta::Column<double> weights(records.data(), records.size(), type->GetMember("weight"));
+		assert(values.size() == 37 && values.stride() == sizeof(Record) && values[3] == 1.5f);
+
+		std::vector<float> packed = values.Gather();
+		std::vector<double> packedWeights = weights.Gather();
+		for(int i = 0; i < 37; ++i)
+		{
+			assert(packed[i] == i * 0.5f && packedWeights[i] == i * 2.0);
+			packed[i] *= 2.0f;
+		}
+
+		values.Scatter(packed.data());
+		for(int i = 0; i < 37; ++i)
+		{
+			assert(records[i].value == (float)i && records[i].id == i && records[i].tag == 'r');
+		}
+
+		bool threw = false;
+		try
+		{
+			meta::Column<float> wrong(records, type->GetMember("id"));
+		}
+		catch(const std::invalid_argument&)
+		{
+			threw = true;
+		}
+		assert(threw);
+
+		std::cout << "Column: ok" << std::endl;
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace ColumnTest
+{
+	void BasicTest();
+}
@@ -0,0 +1,86 @@
+#include "ConvertTest.h"
+#include "Meta.h"
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <assert.h>
+
+namespace ConvertTest
+{
+	struct Meters
+	{
+		double value;
+	};
+}
+
+meta_declare_primitive(ConvertTest::Meters);
+
+namespace ConvertTest
+{
+	class Ruler
+	{
+	public:
+		float scale;
+
+		Ruler() : scale(2.0f) {}
+
+		float Scale(float x) const { return x * scale; }
+		long long Sum(long long a, int b, char c) const { return a + b + c; }
+		double Length(Meters m) const { return m.value; }
+		int Count(const std::string& text) const { return (int)text.size(); }
+
+		meta_declare(Ruler);
+	};
+
+	meta_define(Ruler)
+		.member("scale", &Ruler::scale)
+		.method("Scale", &Ruler::Scale)
+		.method("Sum", &Ruler::Sum)
+		.method("Length", &Ruler::Length)
+		.method("Count", &Ruler::Count)
+		.finish();
+
+	void BasicTest()
+	{
+		const meta::TypeData* type = meta::Get<Ruler>();
+		Ruler ruler;
+
+		// Exact match, widening, narrowing
+		assert(meta::Invoke(type->GetMethod("Scale"), ruler, 1.5f).cast<float>() == 3.0f);
+		assert(meta::Invoke(type->GetMethod("Scale"), ruler, 3).cast<float>() == 6.0f);
+		assert(meta::Invoke(type->GetMethod("Scale"), ruler, 0.25).cast<float>() == 0.5f);
+		assert(meta::Invoke(type->GetMethod("Sum"), ruler, 1, 2.9, 3).cast<long long>() == 6);
+
+		// Same argument types again, through the remembered plan
+		assert(meta::Invoke(type->GetMethod("Sum"), ruler, 10, 20.0, 30).cast<long long>() == 60);
+		assert(meta::Invoke(type->GetMethod("Sum"), ruler, 1ll, 2, 'a').cast<long long>() == 100);
+
+		// Nothing converts a string into Meters until a conversion is registered
+		const meta::Method* length = type->GetMethod("Length");
+		bool threw = false;
+		try { meta::Invoke(length, ruler, 12); } catch(const anyimpl::bad_any_cast&) { threw = true; }
+		assert(threw);
+
+		meta::RegisterConversion<int, Meters>([](int centimeters) { return Meters{ centimeters / 100.0 }; });
+		meta::RegisterConversion<const char*, std::string>();
+		assert(meta::Invoke(length, ruler, 250).cast<double>() == 2.5);
+		assert(meta::Invoke(type->GetMethod("Count"), ruler, "four").cast<int>() == 4);
+
+		assert(meta::ConvertTo<double>(Any(7)) == 7.0);
+		assert(meta::ConvertTo<int>(Any(7.9)) == 7);
+		assert(meta::FindConversion(Any(1).getPolicy(), Any(2).getPolicy()) == nullptr);
+
+		// Floating point values out of range throw rather than convert
+		assert(meta::ConvertTo<int>(Any(-2147483648.75)) == -2147483647 - 1);
+		assert(meta::ConvertTo<unsigned int>(Any(-0.5)) == 0u);
+		int outOfRange = 0;
+		try { meta::ConvertTo<int>(Any(1e20)); } catch(const anyimpl::bad_any_cast&) { ++outOfRange; }
+		try { meta::ConvertTo<unsigned char>(Any(256.0f)); } catch(const anyimpl::bad_any_cast&) { ++outOfRange; }
+		try { meta::ConvertTo<long long>(Any(std::nan(""))); } catch(const anyimpl::bad_any_cast&) { ++outOfRange; }
+		try { meta::ConvertTo<float>(Any(1e300)); } catch(const anyimpl::bad_any_cast&) { ++outOfRange; }
+		try { meta::Invoke(type->GetMethod("Sum"), ruler, 1, 3e9, 'a'); } catch(const anyimpl::bad_any_cast&) { ++outOfRange; }
+		assert(outOfRange == 5);
+
+		std::cout << "Convert: ok" << std::endl;
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace ConvertTest
+{
+	void BasicTest();
+}
@@ -1,4 +1,4 @@
-#include "expressionTest.h"
+#include "ExpressionTest.h"
 #include "expression.h"
 #include "MacroHelpers.h"		// STR() macro
 #include <iostream>
@@ -0,0 +1,191 @@
+#include "HashTest.h"
+#include "MetaHash.h"
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <assert.h>
+
+namespace HashTest
+{
+	struct Vec3
+	{
+		float x, y, z;
+	};
+}
+
+meta_declare_primitive(HashTest::Vec3)
+	.member("x", &HashTest::Vec3::x)
+	.member("y", &HashTest::Vec3::y)
+	.member("z", &HashTest::Vec3::z)
+	.finish();
+
+meta_declare_primitive(std::wstring);
+meta_declare_primitive(std::vector<int>);
+namespace HashTest 
+{ 
+	typedef std::unordered_map<int, float> WeightMap; 
+
+	struct Unhashable
+	{
+		bool operator==(const Unhashable&) const { return true; }
+		bool operator<(const Unhashable&) const { return false; }	// std::vector's are unconstrained
+	};
+	typedef std::vector<Unhashable> Tags;
+}
+meta_declare_primitive(HashTest::WeightMap);
+meta_declare_primitive(HashTest::Tags);
+
+namespace HashTest
+{
+	class Asset
+	{
+	public:
+		int id;
+		char kind;			// followed by padding
+		double scale;
+		Vec3 position;		// expanded, and merged with the span before it
+		std::wstring path;	// std::hash, operator==
+		int unreflected;
+
+		meta_declare(Asset);
+	};
+
+	class Mesh
+	{
+	public:
+		std::vector<int> indices;				// hashed element by element
+		WeightMap weights;						// independently of the order
+		double scale;
+
+		meta_declare(Mesh);
+	};
+
+	meta_define(Mesh)
+		.member("indices", &Mesh::indices)
+		.member("weights", &Mesh::weights)
+		.member("scale", &Mesh::scale)
+		.finish();
+
+	class Tagged
+	{
+	public:
+		int id;
+		Tags tags;
+
+		meta_declare(Tagged);
+	};
+
+	meta_define(Tagged)
+		.member("id", &Tagged::id)
+		.member("tags", &Tagged::tags)
+		.finish();
+
+	meta_define(Asset)
+		.member("id", &Asset::id)
+		.member("kind", &Asset::kind)
+		.member("scale", &Asset::scale)
+		.member("position", &Asset::position)
+		.member("path", &Asset::path)
+		.finish();
+
+	static void FillPadding(Asset& asset, unsigned char value)
+	{
+		const meta::TypeData* type = meta::Get<Asset>();
+		size_t first = type->GetMember("kind")->GetOffset() + 1;
+		std::memset(reinterpret_cast<unsigned char*>(&asset) + first, value, type->GetMember("scale")->GetOffset() - first);
+	}
+
+	static Asset MakeAsset(int id)
+	{
+		Asset asset;
+		asset.id = id;
+		asset.kind = 'm';
+		asset.scale = 1.5;
+		asset.position = Vec3{ 1.0f, 2.0f, 3.0f };
+		asset.path = L"meshes/" + std::to_wstring(id);
+		asset.unreflected = id * 7;
+		return asset;
+	}
+
+	void BasicTest()
+	{
+		Asset a = MakeAsset(1);
+		Asset b = MakeAsset(1);
+
+		// padding and unreflected fields don't matter
+		FillPadding(a, 0xCD);
+		FillPadding(b, 0xAB);
+		b.unreflected = 0;
+		assert(meta::Equal(a, b) && meta::Hash(a) == meta::Hash(b));
+
+		b.path = L"meshes/2";
+		assert(!meta::Equal(a, b) && meta::Hash(a) != meta::Hash(b));
+		b = MakeAsset(1);
+		b.position.z = 4.0f;
+		assert(!meta::Equal(a, b) && meta::Hash(a) != meta::Hash(b));
+
+		// floats are values
+		b = MakeAsset(1);
+		b.scale = -0.0;
+		a.scale = 0.0;
+		assert(meta::Equal(a, b) && meta::Hash(a) == meta::Hash(b));
+		a.scale = b.scale = std::nan("");
+		assert(!meta::Equal(a, a));
+		a = MakeAsset(1);
+
+		// containers
+		Mesh m1, m2;
+		m1.indices = { 1, 2, 3 };
+		m2.indices = { 1, 2, 3 };
+		m1.scale = m2.scale = 1.0;
+		for(int i = 0; i < 100; ++i)
+		{
+			m1.weights[i] = i * 0.5f;
+			m2.weights[99 - i] = (99 - i) * 0.5f;
+		}
+		m2.weights.rehash(1024);
+		assert(meta::Equal(m1, m2) && meta::Hash(m1) == meta::Hash(m2));
+		m2.indices.push_back(4);
+		assert(!meta::Equal(m1, m2) && meta::Hash(m1) != meta::Hash(m2));
+
+		assert(meta::Get<std::vector<int>>()->GetLifecycle().m_hash);
+		assert(!meta::internal::value_hash<Tags>::enabled);
+
+		// a member without a hash is named, and doesn't stop Equal()
+		Tagged tagged;
+		tagged.id = 1;
+		tagged.tags.resize(2);
+		assert(meta::Equal(tagged, tagged));
+		std::string error;
+		try
+		{
+			meta::Hash(tagged);
+		}
+		catch(const std::invalid_argument& e)
+		{
+			error = e.what();
+		}
+		assert(error.find("member tags") != std::string::npos);
+
+		// a padding-free float POD is one span, hashed as its bytes
+		Vec3 v = { 1.0f, 2.0f, 3.0f };
+		assert(meta::Hash(v) == meta::internal::HashBytes(&v, sizeof(v), 0));
+
+		std::vector<Asset> assets;
+		for(int i = 0; i < 100; ++i)
+		{
+			assets.push_back(MakeAsset(i % 50));
+		}
+		std::vector<uint64_t> hashes(assets.size());
+		meta::HashBatch(meta::Get<Asset>(), assets.data(), assets.size(), hashes.data());
+		assert(hashes[3] == meta::Hash(assets[3]) && hashes[3] == hashes[53]);
+
+		std::unordered_set<Asset, meta::Hasher<Asset>, meta::EqualTo<Asset>> unique(assets.begin(), assets.end());
+		assert(unique.size() == 50);
+
+		std::cout << "Hash: ok" << std::endl;
+	}
+}
@@ -1,55 +1,74 @@
 #pragma once
 
 #include <cstddef>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 
 template <unsigned int... Is>
 struct indices {};
 
-template <unsigned int N, unsigned int... Is>
-struct build_indices : build_indices<N - 1, N - 1, Is...> {};
+namespace indices_detail
+{
+	template <typename Sequence>
+	struct to_indices;
 
-template <unsigned int... Is>
-struct build_indices<0, Is...> : indices<Is...>{};
+	template <unsigned int... Is>
+	struct to_indices<std::integer_sequence<unsigned int, Is...>>
+	{
+		typedef indices<Is...> type;
+	};
+
+	// select_type base: each type in the pack becomes a base class tagged with its index,
+	// so the Nth type is found by overload resolution instead of N recursive instantiations.
+	template <std::size_t I, typename T>
+	struct indexed_type
+	{
+		typedef T type;
+	};
+
+	template <typename Sequence, typename... Args>
+	struct indexed_types;
+
+	template <std::size_t... Is, typename... Args>
+	struct indexed_types<std::index_sequence<Is...>, Args...> : indexed_type<Is, Args>... {};
+
+	template <std::size_t I, typename T>
+	indexed_type<I, T> find_indexed_type(const indexed_type<I, T>&);
+}
+
+// build_indices<N> is indices<0, ..., N-1>. 
+// Built on std::make_integer_sequence, which compilers generate without recursion.
+template <unsigned int N>
+using build_indices = typename indices_detail::to_indices<std::make_integer_sequence<unsigned int, N>>::type;
 
 
 template<unsigned int... Is>
-indices<Is...> toIndices(indices< Is...>& ind)
+indices<Is...> toIndices(const indices< Is...>& ind)
 {
 	return ind;
 }
 
 
-template <std::size_t N, typename... Args> struct select 
-{ 
-	static_assert(N < sizeof...(Args), "select<N, Args...>, index out of bounds.");
-	typedef void type; // declare typedef to avoid template barf, assert should catch first
-};
- 
-template <std::size_t N, typename T, typename... Args> 
-struct select<N, T, Args...> 
+// The Nth type of Args, and the Nth value of a matching parameter list.
+// (Not named select, which collides with POSIX ::select.)
+template <std::size_t N, typename... Args> 
+struct select_type 
 { 
-	typedef typename select<N - 1, Args...>::type type; 
+	static_assert(N < sizeof...(Args), "select_type<N, Args...>, index out of bounds.");
+
+	typedef typename decltype(indices_detail::find_indexed_type<N>(
+		std::declval<indices_detail::indexed_types<std::index_sequence_for<Args...>, Args...>>()))::type type;
   
-	static inline const type& get(const T&, const Args&... args)
-	{ 
-		return select<N - 1, Args...>::get(args...); 
-	}
-};
- 
-template <typename T, typename... Args> 
-struct select<0, T, Args...> 
-{ 
-	typedef T type; 
- 
-	static inline const type& get(const T& a, const Args&...)
+	static inline const type& get(const Args&... args)
 	{ 
-		return a; 
+		const void* values[] = { &args... };
+		return *static_cast<const type*>(values[N]); 
 	}
 };
 
 template<std::size_t N, typename... Args>
-typename select<N, Args...>::type select_parameter(Args... args) { return select<N, Args...>::get(args...); }
+typename select_type<N, Args...>::type select_parameter(Args... args) { return select_type<N, Args...>::get(args...); }
 
 
 
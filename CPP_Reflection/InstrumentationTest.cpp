@@ -0,0 +1,92 @@
+#include "InstrumentationTest.h"
+#include "Meta.h"
+#include <iostream>
+#include <assert.h>
+#include <thread>
+
+namespace InstrumentationTest
+{
+	class Counter
+	{
+		int m_count;
+		uint64_t m_version;
+
+	public:
+		Counter() : m_count(0), m_version(meta::NextVersion()) {}
+
+		int increment(int by) { m_count += by; m_version = meta::NextVersion(); return m_count; }
+		int get() const { return m_count; }
+		uint64_t GetVersion() const { return m_version; }
+
+		meta_declare(Counter);
+	};
+
+	meta_define(Counter)
+		.method("increment", &Counter::increment)
+		.method("get", &Counter::get)
+		.pure_method("cached", &Counter::get)
+		.finish();
+
+	void BasicTest()
+	{
+	#if META_INSTRUMENTATION
+		using namespace meta::instrumentation;
+
+		Counter counter;
+		const meta::Method* increment = meta::Get<Counter>()->GetMethod("increment");
+
+		// not counted while disabled
+		meta::Invoke(increment, counter, 1);
+
+		SetSamplePeriod(1);
+		SetEnabled(true);
+		for(int i = 0; i < 10; ++i)
+		{
+			meta::Invoke(increment, counter, 1);
+		}
+
+		// counts from other threads are aggregated
+		std::thread worker([&]() { Counter local; meta::Invoke(increment, local, 1); });
+		worker.join();
+		SetEnabled(false);
+
+		// memoized calls are counted whether or not they hit
+		SetEnabled(true);
+		const meta::Method* cached = meta::Get<Counter>()->GetMethod("cached");
+		for(int i = 0; i < 3; ++i)
+		{
+			meta::Invoke(cached, counter);
+		}
+		SetEnabled(false);
+
+		std::vector<MethodStats> report = Report();
+		const MethodStats* stats = nullptr;
+		const MethodStats* cachedStats = nullptr;
+		for(const MethodStats& entry : report)
+		{
+			if(entry.m_typeName == "InstrumentationTest::Counter" && entry.m_methodName == "increment")
+			{
+				stats = &entry;
+			}
+			if(entry.m_typeName == "InstrumentationTest::Counter" && entry.m_methodName == "cached")
+			{
+				cachedStats = &entry;
+			}
+		}
+
+		assert(stats && stats->m_calls == 11);
+		assert(cachedStats && cachedStats->m_calls == 3);
+		uint64_t histogramCalls = 0;
+		for(unsigned int b = 0; b < c_histogramBuckets; ++b)
+		{
+			histogramCalls += stats->m_histogram[b];
+		}
+		assert(histogramCalls == 11 && stats->m_sampledCalls == 11);
+		SetSamplePeriod(16);
+
+		PrintReport(std::cout);
+	#else
+		std::cout << "Instrumentation compiled out (META_INSTRUMENTATION=0)" << std::endl;
+	#endif
+	}
+}
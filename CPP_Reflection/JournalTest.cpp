@@ -0,0 +1,120 @@
+#include "JournalTest.h"
+#include "MetaJournal.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <assert.h>
+
+namespace JournalTest
+{
+	class Light
+	{
+	public:
+		int id;
+		float intensity;
+		double range;
+		std::string name;
+		float payload[256];	// keeps the object large, as a snapshot would be
+
+		Light() : id(0), intensity(1.0f), range(10.0), payload() {}
+
+		meta_declare(Light);
+	};
+
+	meta_define(Light)
+		.member("id", &Light::id)
+		.member("intensity", &Light::intensity)
+		.member("range", &Light::range)
+		.member("name", &Light::name)
+		.finish();
+
+	void BasicTest()
+	{
+		const meta::TypeData* type = meta::Get<Light>();
+		const meta::Member* intensity = type->GetMember("intensity");
+		const meta::Member* range = type->GetMember("range");
+
+		meta::Journal journal;
+		Light a, b;
+		assert(!journal.CanUndo() && !journal.Undo() && !journal.Redo());
+
+		// one step of two writes
+		journal.Write(&a, intensity, 2.0f);
+		journal.Write(&b, range, 20.0);
+		journal.Commit();
+		assert(a.intensity == 2.0f && b.range == 20.0);
+
+		// a drag: consecutive writes to one member coalesce into one entry
+		size_t before = journal.GetBytesUsed();
+		for(int i = 1; i <= 100; ++i)
+		{
+			journal.Write(&a, intensity, 2.0f + i);
+		}
+		journal.Commit();
+		assert(a.intensity == 102.0f);
+		assert(journal.GetBytesUsed() - before == 24);	// header, old and new float
+		assert(journal.GetBytesUsed() < sizeof(Light));
+		assert(journal.GetStepCount() == 2);
+
+		assert(journal.Undo() && a.intensity == 2.0f);
+		assert(journal.Undo() && a.intensity == 1.0f && b.range == 10.0);
+		assert(!journal.Undo());
+		assert(journal.Redo() && a.intensity == 2.0f && b.range == 20.0);
+		assert(journal.Redo() && a.intensity == 102.0f);
+		assert(!journal.Redo());
+
+		// a write after an undo discards the redo
+		assert(journal.Undo());
+		journal.Write(&b, range, 5.0);
+		assert(!journal.CanRedo());
+		assert(journal.Undo() && b.range == 20.0 && a.intensity == 2.0f);	// uncommitted writes are committed first
+		assert(journal.GetStepCount() == 2);
+
+		// steps span chunks
+		meta::Journal small(64);
+		std::vector<Light> scene(50);
+		for(int step = 0; step < 3; ++step)
+		{
+			for(Light& light : scene)
+			{
+				small.Write(&light, type->GetMember("id"), step + 1);
+				small.Write(&light, range, step * 2.0);
+			}
+			small.Commit();
+		}
+		assert(small.GetBytesReserved() >= small.GetBytesUsed());
+		assert(small.Undo() && small.Undo());
+		for(const Light& light : scene)
+		{
+			assert(light.id == 1 && light.range == 0.0);
+		}
+		assert(small.Redo() && small.Redo() && scene[49].id == 3 && scene[49].range == 4.0);
+		small.Clear();
+		assert(!small.CanUndo());
+
+		bool threw = false;
+		try
+		{
+			journal.Write(&a, type->GetMember("name"), std::string("key"));
+		}
+		catch(const std::invalid_argument&)
+		{
+			threw = true;
+		}
+		assert(threw);
+
+		// an int is the size of a float, but not a float
+		threw = false;
+		try
+		{
+			journal.Write(&a, intensity, 3);
+		}
+		catch(const std::invalid_argument&)
+		{
+			threw = true;
+		}
+		assert(threw && a.intensity != 3.0f);
+
+		std::cout << "Journal: ok" << std::endl;
+	}
+}
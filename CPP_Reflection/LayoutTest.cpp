@@ -0,0 +1,70 @@
+#include "LayoutTest.h"
+#include "MetaLayout.h"
+#include <iostream>
+#include <assert.h>
+
+namespace LayoutTest
+{
+	struct Padded
+	{
+		char a;
+		double b;
+		char c;
+		int d;
+	};
+
+	// only part of it is reflected, so it gets no suggestion
+	struct Partial
+	{
+		char a;
+		double hidden[4];
+		int d;
+	};
+}
+
+meta_declare_primitive(LayoutTest::Padded)
+	.member("a", &LayoutTest::Padded::a)
+	.member("b", &LayoutTest::Padded::b)
+	.member("c", &LayoutTest::Padded::c)
+	.member("d", &LayoutTest::Padded::d)
+	.finish();
+
+meta_declare_primitive(LayoutTest::Partial)
+	.member("a", &LayoutTest::Partial::a)
+	.member("d", &LayoutTest::Partial::d)
+	.finish();
+
+namespace LayoutTest
+{
+	void BasicTest()
+	{
+		const meta::TypeData* padded = meta::Get<Padded>();
+		assert(padded->GetAlignment() == alignof(Padded));
+		assert(padded->GetMember("c")->GetOffset() == offsetof(Padded, c));
+		assert(padded->GetFlags() & meta::TypeLifecycle::F_StandardLayout);
+
+		Padded value = { 'x', 2.5, 'y', 4 };
+		assert(*static_cast<double*>(padded->GetMember("b")->GetPointer(&value)) == 2.5);
+
+		meta::TypeLayout layout = meta::GetLayout(padded);
+		assert(layout.m_members.size() == 4 && layout.m_members[1].m_member->GetNameStr() == "b");
+		assert(layout.m_paddingBytes == sizeof(Padded) - (2 * sizeof(char) + sizeof(double) + sizeof(int)));
+
+		std::vector<meta::LayoutSuggestion> suggestions = meta::AnalyzeLayouts(1000000);
+		const meta::LayoutSuggestion* suggestion = nullptr;
+		for(const meta::LayoutSuggestion& entry : suggestions)
+		{
+			assert(entry.m_type != meta::Get<Partial>());
+			if(entry.m_type == padded)
+			{
+				suggestion = &entry;
+			}
+		}
+
+		assert(suggestion && suggestion->m_suggestedSize == 16);
+		assert(suggestion->m_order[0]->GetNameStr() == "b" && suggestion->m_order[1]->GetNameStr() == "d");
+		assert(suggestion->m_bytesSaved == (sizeof(Padded) - 16) * 1000000);
+
+		meta::PrintLayoutReport(std::cout, 1000000);
+	}
+}
@@ -0,0 +1,187 @@
+#include "LifecycleTest.h"
+#include "Meta.h"
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <assert.h>
+#include <thread>
+
+namespace LifecycleTest
+{
+	class Widget
+	{
+	public:
+		static int s_live;
+
+		int m_id;
+		std::string m_label;
+
+		Widget() : m_id(7), m_label("widget") { ++s_live; }
+		Widget(const Widget& rhs) : m_id(rhs.m_id), m_label(rhs.m_label) { ++s_live; }
+		Widget(Widget&& rhs) : m_id(rhs.m_id), m_label(std::move(rhs.m_label)) { ++s_live; }
+		virtual ~Widget() { --s_live; }
+
+		meta_declare(Widget);
+	};
+
+	int Widget::s_live = 0;
+
+	meta_define(Widget)
+		.member("m_id", &Widget::m_id)
+		.finish();
+
+	struct alignas(64) Aligned
+	{
+		float m_lanes[16];
+
+		meta_declare(Aligned);
+	};
+
+	meta_define(Aligned).finish();
+
+	class NoDefault
+	{
+		int m_value;
+
+	public:
+		NoDefault(int value) : m_value(value) {}
+
+		meta_declare(NoDefault);
+	};
+
+	meta_define(NoDefault).finish();
+
+	struct Plain
+	{
+		int m_x;
+		float m_y;
+	};
+}
+
+meta_declare_primitive(LifecycleTest::Plain);
+
+namespace LifecycleTest
+{
+	static void ArrayTest()
+	{
+		const meta::TypeData* widgetType = meta::Get<Widget>();
+		assert(!(widgetType->GetLifecycle().m_flags & meta::TypeLifecycle::F_TriviallyCopyable));
+
+		alignas(Widget) unsigned char first[sizeof(Widget) * 8];
+		alignas(Widget) unsigned char second[sizeof(Widget) * 8];
+		alignas(Widget) unsigned char third[sizeof(Widget) * 8];
+
+		widgetType->ConstructArray(first, 8);
+		assert(Widget::s_live == 8);
+		reinterpret_cast<Widget*>(first)[3].m_id = 3;
+
+		widgetType->CopyArray(second, first, 8);
+		assert(Widget::s_live == 16 && reinterpret_cast<Widget*>(second)[3].m_id == 3);
+
+		widgetType->RelocateArray(third, second, 8);
+		assert(Widget::s_live == 16 && reinterpret_cast<Widget*>(third)[3].m_id == 3 && reinterpret_cast<Widget*>(third)[7].m_label == "widget");
+
+		widgetType->DestroyArray(first, 8);
+		widgetType->DestroyArray(third, 8);
+		assert(Widget::s_live == 0);
+
+		// trivial types take the memset/memcpy paths
+		const meta::TypeData* plainType = meta::Get<Plain>();
+		unsigned int plainFlags = plainType->GetLifecycle().m_flags;
+		unsigned int trivial = meta::TypeLifecycle::F_ZeroConstructible | meta::TypeLifecycle::F_TriviallyDestructible | meta::TypeLifecycle::F_TriviallyCopyable;
+		assert((plainFlags & trivial) == trivial);
+
+		Plain plains[4];
+		std::memset(plains, 0xFF, sizeof(plains));
+		plainType->ConstructArray(plains, 4);
+		assert(plains[3].m_x == 0 && plains[3].m_y == 0.0f);
+
+		plains[2].m_x = 5;
+		Plain copies[4];
+		plainType->CopyArray(copies, plains, 4);
+		plainType->DestroyArray(copies, 4);
+		assert(copies[2].m_x == 5);
+
+		plainType->ConstructArray(nullptr, 0);
+	}
+
+	void BasicTest()
+	{
+		const meta::TypeData* widgetType = meta::Get_Name("LifecycleTest::Widget");
+		assert(widgetType->GetAlignment() == alignof(Widget));
+
+		Widget* widget = static_cast<Widget*>(widgetType->Create());
+		assert(Widget::s_live == 1 && widget->m_id == 7 && widget->GetType() == widgetType);
+
+		widget->m_id = 9;
+		Widget* copy = static_cast<Widget*>(widgetType->CreateCopy(widget));
+		Widget* moved = static_cast<Widget*>(widgetType->CreateMove(widget));
+		assert(Widget::s_live == 3 && copy->m_id == 9 && moved->m_label == "widget" && copy != widget);
+
+		widgetType->Destroy(widget);
+		widgetType->Destroy(copy);
+		widgetType->Destroy(moved);
+		assert(Widget::s_live == 0);
+
+		// blocks are aligned for the type
+		const meta::TypeData* alignedType = meta::Get<Aligned>();
+		for(int i = 0; i < 100; ++i)
+		{
+			void* aligned = alignedType->Create();
+			assert(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+			alignedType->Destroy(aligned);
+		}
+
+		// freed blocks are reused
+		void* first = widgetType->Create();
+		widgetType->Destroy(first);
+		void* second = widgetType->Create();
+		assert(first == second);
+		widgetType->Destroy(second);
+
+		// blocks freed on another thread
+		std::vector<void*> widgets;
+		for(int i = 0; i < 1000; ++i)
+		{
+			widgets.push_back(widgetType->Create());
+		}
+		std::thread worker([&]()
+		{
+			for(void* instance : widgets)
+			{
+				widgetType->Destroy(instance);
+			}
+		});
+		worker.join();
+		assert(Widget::s_live == 0);
+
+		bool threw = false;
+		try
+		{
+			meta::Get<NoDefault>()->Create();
+		}
+		catch(const std::logic_error&)
+		{
+			threw = true;
+		}
+		assert(threw && meta::Get<NoDefault>()->GetLifecycle().m_copyConstruct);
+
+		// pools are made by the first Create(), so there's nothing to free a Plain into
+		threw = false;
+		try
+		{
+			Plain plain = {};
+			meta::Get<Plain>()->Destroy(&plain);
+		}
+		catch(const std::logic_error&)
+		{
+			threw = true;
+		}
+		assert(threw);
+
+		ArrayTest();
+
+		std::cout << "Lifecycle: ok" << std::endl;
+	}
+}
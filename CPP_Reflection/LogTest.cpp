@@ -0,0 +1,154 @@
+#include "LogTest.h"
+#include "MetaLog.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <assert.h>
+
+namespace LogTest
+{
+	struct Vec2
+	{
+		float x, y;
+	};
+
+	// Trivially copyable: logged with one memcpy
+	struct Order
+	{
+		int id;
+		double price;
+		Vec2 position;
+	};
+}
+
+meta_declare_primitive(LogTest::Vec2)
+	.member("x", &LogTest::Vec2::x)
+	.member("y", &LogTest::Vec2::y)
+	.finish();
+
+meta_declare_primitive(LogTest::Order)
+	.member("id", &LogTest::Order::id)
+	.member("price", &LogTest::Order::price)
+	.member("position", &LogTest::Order::position)
+	.finish();
+
+namespace LogTest
+{
+	// Not trivially copyable (it has a vtable): logged field by field, the pointer left out
+	class Session
+	{
+	public:
+		int id;
+		char state;
+		const char* owner;
+		float load;
+
+		Session() : id(0), state(0), owner(nullptr), load(0.0f) {}
+
+		meta_declare(Session);
+	};
+
+	meta_define(Session)
+		.member("id", &Session::id)
+		.member("state", &Session::state)
+		.member("owner", &Session::owner)
+		.member("load", &Session::load)
+		.finish();
+
+	static size_t Count(const std::string& text, const std::string& part)
+	{
+		size_t count = 0;
+		for(size_t at = text.find(part); at != std::string::npos; at = text.find(part, at + 1))
+		{
+			++count;
+		}
+		return count;
+	}
+
+	void BasicTest()
+	{
+		using namespace meta::logging;
+
+		Order order = { 7, 9.5, Vec2{ 1.0f, -2.0f } };
+		assert(Log(order));
+
+		Session session;
+		session.id = 3;
+		session.state = 'r';
+		session.owner = "someone";
+		session.load = 0.25f;
+		assert(Log(session));
+		assert(Log(meta::Get<int>(), &session.id));
+
+		std::thread worker([]() { Order other = { 8, 1.0, Vec2{ 0.0f, 0.0f } }; Log(other); });
+		worker.join();
+
+		std::ostringstream text;
+		assert(Drain(text) == 4);
+		std::string log = text.str();
+		assert(log.find("LogTest::Order { id = 7, price = 9.5, position.x = 1, position.y = -2 }") != std::string::npos);
+		assert(log.find("LogTest::Session { id = 3, state = 114, load = 0.25 }") != std::string::npos);
+		assert(log.find(": int { 3 }") != std::string::npos);
+		assert(log.find("thread 1: LogTest::Order { id = 8,") != std::string::npos);
+
+		// drained records are gone
+		std::ostringstream empty;
+		assert(Drain(empty) == 0 && empty.str().empty());
+
+		// an exited thread's drained buffer goes to the next thread, which gets a new id
+		const meta::logging::internal::ThreadLog* first = nullptr;
+		const meta::logging::internal::ThreadLog* second = nullptr;
+		std::thread([&]() { Log(order); first = meta::logging::internal::t_threadLog; }).join();
+		std::thread([&]() { Log(order); second = meta::logging::internal::t_threadLog; }).join();
+		assert(first && second != first);
+		{
+			std::ostringstream drained;
+			assert(Drain(drained) == 2);
+		}
+		const meta::logging::internal::ThreadLog* third = nullptr;
+		std::thread([&]() { Log(order); third = meta::logging::internal::t_threadLog; }).join();
+		assert(third == first || third == second);
+		{
+			std::ostringstream drained;
+			assert(Drain(drained) == 1 && drained.str().find("thread 4: LogTest::Order") != std::string::npos);
+		}
+
+		// formatted offline, while the ring wraps around
+		uint64_t dropped = GetDropped();
+		for(int i = 0; i < 3; ++i)
+		{
+			for(unsigned int r = 0; r < c_logBufferBytes / 64; ++r)
+			{
+				order.id = (int)r;
+				assert(Log(order));
+			}
+
+			std::stringstream binary;
+			assert(DrainBinary(binary) == c_logBufferBytes / 64);
+			std::ostringstream formatted;
+			assert(FormatBinary(binary, formatted));
+			assert(Count(formatted.str(), "LogTest::Order {") == c_logBufferBytes / 64);
+		}
+
+		// a full buffer drops, until drained
+		while(Log(order));
+		assert(GetDropped() == dropped + 1);
+		{
+			std::ostringstream drained;
+			{
+				BackgroundDrain background(drained, std::chrono::milliseconds(1));
+			}
+			assert(Count(drained.str(), "LogTest::Order {") > 0);
+		}
+		assert(Log(order));
+		std::ostringstream last;
+		assert(Drain(last) == 1);
+
+		std::istringstream garbage("not a log");
+		std::ostringstream ignored;
+		assert(!FormatBinary(garbage, ignored));
+
+		std::cout << "Log: ok" << std::endl;
+	}
+}
@@ -0,0 +1,125 @@
+#include "MemoTest.h"
+#include "Meta.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <assert.h>
+
+namespace MemoTest
+{
+	// Versioned: changes are picked up without invalidating
+	class Grid
+	{
+	public:
+		int m_scale;
+		uint64_t m_version;
+		mutable int m_computed;
+
+		Grid() : m_scale(1), m_version(meta::NextVersion()), m_computed(0) {}
+
+		void SetScale(int scale) { m_scale = scale; m_version = meta::NextVersion(); }
+		uint64_t GetVersion() const { return m_version; }
+
+		int PathCost(int from, int to) const { ++m_computed; return (to - from) * m_scale; }
+		std::string Describe(const std::string& prefix) const { ++m_computed; return prefix + std::to_string(m_scale); }
+		int Uncached(int x) const { ++m_computed; return x; }
+
+		meta_declare(Grid);
+	};
+
+	meta_define(Grid)
+		.member("scale", &Grid::m_scale)
+		.pure_method("PathCost", &Grid::PathCost)
+		.pure_method("Describe", &Grid::Describe)
+		.method("Uncached", &Grid::Uncached)
+		.finish();
+
+	// Changed behind its version's back: callers invalidate
+	class Stats
+	{
+	public:
+		int m_base;
+		uint64_t m_version;
+		mutable int m_computed;
+
+		Stats() : m_base(10), m_version(meta::NextVersion()), m_computed(0) {}
+
+		uint64_t GetVersion() const { return m_version; }
+		int Total() const { ++m_computed; return m_base * 2; }
+
+		meta_declare(Stats);
+	};
+
+	meta_define(Stats)
+		.pure_method("Total", &Stats::Total, 16)
+		.finish();
+
+	void BasicTest()
+	{
+		const meta::TypeData* gridType = meta::Get<Grid>();
+		const meta::Method* pathCost = gridType->GetMethod("PathCost");
+		const meta::Method* describe = gridType->GetMethod("Describe");
+
+		Grid grid;
+		assert(meta::Invoke(pathCost, grid, 2, 7).cast<int>() == 5);
+		assert(meta::Invoke(pathCost, grid, 2, 7).cast<int>() == 5);
+		assert(grid.m_computed == 1);
+
+		// Different arguments, then a different receiver
+		assert(meta::Invoke(pathCost, grid, 1, 7).cast<int>() == 6 && grid.m_computed == 2);
+		Grid other;
+		assert(meta::Invoke(pathCost, other, 2, 7).cast<int>() == 5 && other.m_computed == 1);
+
+		// A version bump misses
+		grid.SetScale(3);
+		assert(meta::Invoke(pathCost, grid, 2, 7).cast<int>() == 15 && grid.m_computed == 3);
+
+		assert(meta::Invoke(describe, grid, std::string("scale ")).cast<std::string>() == "scale 3");
+		assert(meta::Invoke(describe, grid, std::string("scale ")).cast<std::string>() == "scale 3" && grid.m_computed == 4);
+
+		meta::Invoke(gridType->GetMethod("Uncached"), grid, 1);
+		meta::Invoke(gridType->GetMethod("Uncached"), grid, 1);
+		assert(grid.m_computed == 6);
+
+		// A new object in a destroyed one's pool slot doesn't get its results
+		Grid* first = static_cast<Grid*>(gridType->Create());
+		first->SetScale(4);
+		assert(meta::Invoke(pathCost, *first, 2, 7).cast<int>() == 20);
+		gridType->Destroy(first);
+		Grid* second = static_cast<Grid*>(gridType->Create());
+		assert(meta::Invoke(pathCost, *second, 2, 7).cast<int>() == 5 && second->m_computed == 1);
+		gridType->Destroy(second);
+
+		const meta::Method* total = meta::Get<Stats>()->GetMethod("Total");
+		Stats stats;
+		assert(meta::Invoke(total, stats).cast<int>() == 20);
+		stats.m_base = 5;
+		assert(meta::Invoke(total, stats).cast<int>() == 20 && stats.m_computed == 1);
+		meta::InvalidateMemoized();
+		assert(meta::Invoke(total, stats).cast<int>() == 10 && stats.m_computed == 2);
+
+		// Concurrent callers share the cache
+		std::vector<Grid> grids(8);
+		std::vector<std::thread> threads;
+		for(int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&]()
+			{
+				for(int i = 0; i < 1000; ++i)
+				{
+					Grid& g = grids[i % grids.size()];
+					int cost = meta::Invoke(pathCost, g, 0, i % 3).cast<int>();
+					assert(cost == i % 3);
+					(void)cost;
+				}
+			});
+		}
+		for(std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		std::cout << "Memo: ok" << std::endl;
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace MemoTest
+{
+	void BasicTest();
+}
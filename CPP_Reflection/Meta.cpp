@@ -1,38 +1,321 @@
 #include "Meta.h"
+#include <cstring>
+#include <mutex>
+
+// The registry and the built-in types are used by the static initializers of every other translation unit, 
+// so they're initialized before them.
+#if defined(_MSC_VER)
+	#pragma warning(disable : 4073)
+	#pragma init_seg(lib)
+	#define META_INIT_FIRST
+#else
+	#define META_INIT_FIRST __attribute__((init_priority(101)))
+#endif
+
+#define meta_declare_builtin(T) \
+	template<> const meta::TypeData_Creator meta::internal::TypeDataHolder<T>::s_TypeData META_INIT_FIRST = meta::internal::TypeDataBuilder<T, false>()
 
 namespace meta
 {
-	const TypeData internal::TypeDataHolder<void>::s_TypeData("void", 0);
+	const TypeData internal::TypeDataHolder<void>::s_TypeData META_INIT_FIRST (internal::TypeName<void>::c_str(), internal::TypeName<void>::hash, 0);
+
+	const TypeData* Member::GetStorageType() const
+	{
+		static const TypeData s_pointerType(internal::TypeName<void*>::c_str(), internal::TypeName<void*>::hash, 
+			sizeof(void*), alignof(void*), internal::MakeLifecycle<void*>());
+
+		return IsPointer() ? &s_pointerType : GetType();
+	}
+
+	std::atomic<uint64_t> internal::g_memoGeneration(0);
+
+	void InvalidateMemoized()
+	{
+		internal::g_memoGeneration.fetch_add(1, std::memory_order_acq_rel);
+	}
+
+	uint64_t NextVersion()
+	{
+		static std::atomic<uint64_t> s_nextVersion(1);
+		return s_nextVersion.fetch_add(1, std::memory_order_relaxed);
+	}
 
-	size_t Member::GetSize()
+	void Method::ResolveSignature() const
 	{
-		return m_type->GetSize();
+		static std::mutex s_resolveMutex;
+		std::lock_guard<std::mutex> lock(s_resolveMutex);
+
+		if(m_resolved.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		for(unsigned int i = 0; i < m_arity; ++i)
+		{
+			m_paramTypes[i] = m_paramDescs[i].Resolve();
+		}
+		m_returnType = m_returnDesc.Resolve();
+
+		m_resolved.store(true, std::memory_order_release);
 	}
 
-	static_vector<TypeData> TypeData::s_TypeDataStorage(256);
+	static_vector<TypeData> TypeData::s_TypeDataStorage META_INIT_FIRST (TYPEDATA_CONTAINER_SIZE);
 
-	std::unordered_map<std::string, unsigned int> TypeData::sTypeDictionary = [=]()-> std::unordered_map<std::string, unsigned int>
+	std::unordered_map<uint64_t, unsigned int> TypeData::sTypeDictionary META_INIT_FIRST = []()-> std::unordered_map<uint64_t, unsigned int>
 	{
-		std::unordered_map<std::string, unsigned int> map;
+		std::unordered_map<uint64_t, unsigned int> map;
 
 		// Max load factor is 1.0, so 2.5 is big enough to allow TYPEDATA_CONTAINER_SIZE elements without resizing.
-		typedef std::unordered_map<std::string, unsigned int>::size_type map_size_t;
+		typedef std::unordered_map<uint64_t, unsigned int>::size_type map_size_t;
 		map_size_t reservedSize = (map_size_t)(TYPEDATA_CONTAINER_SIZE*2.5f);
 		map.reserve(reservedSize);
 
-		return std::move(map);
+		return map;
 	}();
 
-	const TypeData* Get_Name(std::string typeName)
+	// Standard spellings of library types whose registered names are whatever the compiler calls them.
+	static const std::pair<const char*, const char*> s_typeNameAliases[] =
 	{
-		unsigned int index = TypeData::GetTypeDataDictionary()->at(typeName);
-		const TypeData* type = &TypeData::GetTypeDataStorage()->at(index);
-		return type;
+		{ "std::string", internal::TypeName<std::string>::c_str() },
+		{ "std::wstring", internal::TypeName<std::wstring>::c_str() },
+	};
+
+	const TypeData* Get_Name(const std::string& typeName)
+	{
+		return Get_Name(typeName.c_str());
 	}
 
 	const TypeData* Get_Name(const char* typeName)
 	{
-		return Get_Name(std::string(typeName));
+		for(const auto& alias : s_typeNameAliases)
+		{
+			if(std::strcmp(typeName, alias.first) == 0)
+			{
+				typeName = alias.second;
+				break;
+			}
+		}
+
+		const std::unordered_map<uint64_t, unsigned int>& dictionary = *TypeData::GetTypeDataDictionary();
+		auto found = dictionary.find(internal::HashName(typeName));
+		if(found == dictionary.end())
+		{
+			throw std::out_of_range("Get_Name(), no type with this name");
+		}
+		const TypeData* type = &TypeData::GetTypeDataStorage()->at(found->second);
+
+		// a different name that happens to share the hash
+		if(std::strcmp(typeName, type->GetName()) != 0)
+		{
+			throw std::out_of_range("Get_Name(), no type with this name");
+		}
+		return type;
+	}
+
+	internal::SlabPool* TypeData::GetPool() const
+	{
+		internal::SlabPool* pool = m_pool.load(std::memory_order_acquire);
+		if(pool || !m_size)
+		{
+			return pool;
+		}
+
+		// Racing first calls each make one, the loser deletes its own.
+		internal::SlabPool* created = new internal::SlabPool(m_size, m_alignment);
+		if(m_pool.compare_exchange_strong(pool, created, std::memory_order_acq_rel))
+		{
+			return created;
+		}
+		delete created;
+		return pool;
+	}
+
+	void* TypeData::Create() const
+	{
+		internal::SlabPool* pool = m_lifecycle.m_construct ? GetPool() : nullptr;
+		if(!pool)
+		{
+			throw std::logic_error("TypeData::Create(), type is not default constructible");
+		}
+
+		void* instance = pool->Allocate();
+		try
+		{
+			m_lifecycle.m_construct(instance);
+		}
+		catch(...)
+		{
+			pool->Deallocate(instance);
+			throw;
+		}
+		return instance;
+	}
+
+	void* TypeData::CreateCopy(const void* source) const
+	{
+		internal::SlabPool* pool = m_lifecycle.m_copyConstruct ? GetPool() : nullptr;
+		if(!pool)
+		{
+			throw std::logic_error("TypeData::CreateCopy(), type is not copy constructible");
+		}
+
+		void* instance = pool->Allocate();
+		try
+		{
+			m_lifecycle.m_copyConstruct(instance, source);
+		}
+		catch(...)
+		{
+			pool->Deallocate(instance);
+			throw;
+		}
+		return instance;
+	}
+
+	void* TypeData::CreateMove(void* source) const
+	{
+		internal::SlabPool* pool = m_lifecycle.m_moveConstruct ? GetPool() : nullptr;
+		if(!pool)
+		{
+			throw std::logic_error("TypeData::CreateMove(), type is not move constructible");
+		}
+
+		void* instance = pool->Allocate();
+		try
+		{
+			m_lifecycle.m_moveConstruct(instance, source);
+		}
+		catch(...)
+		{
+			pool->Deallocate(instance);
+			throw;
+		}
+		return instance;
+	}
+
+	void TypeData::Destroy(void* instance) const
+	{
+		if(!instance)
+		{
+			return;
+		}
+
+		internal::SlabPool* pool = m_pool.load(std::memory_order_acquire);
+		if(!pool)
+		{
+			throw std::logic_error("TypeData::Destroy(), no instance of this type was created");
+		}
+
+		if(!(m_lifecycle.m_flags & TypeLifecycle::F_TriviallyDestructible) && m_lifecycle.m_destruct)
+		{
+			m_lifecycle.m_destruct(instance);
+		}
+		pool->Deallocate(instance);
+	}
+
+	void TypeData::ConstructArray(void* at, size_t count) const
+	{
+		if(!count)
+		{
+			return;
+		}
+
+		if(m_lifecycle.m_flags & TypeLifecycle::F_ZeroConstructible)
+		{
+			std::memset(at, 0, m_size * count);
+		}
+		else if(m_lifecycle.m_constructArray)
+		{
+			m_lifecycle.m_constructArray(at, count);
+		}
+		else
+		{
+			throw std::logic_error("TypeData::ConstructArray(), type is not default constructible");
+		}
+	}
+
+	void TypeData::DestroyArray(void* at, size_t count) const
+	{
+		if(!count)
+		{
+			return;
+		}
+
+		if(m_lifecycle.m_flags & TypeLifecycle::F_TriviallyDestructible)
+		{
+			return;
+		}
+		else if(m_lifecycle.m_destructArray)
+		{
+			m_lifecycle.m_destructArray(at, count);
+		}
+		else
+		{
+			throw std::logic_error("TypeData::DestroyArray(), type is not destructible");
+		}
+	}
+
+	void TypeData::CopyArray(void* at, const void* source, size_t count) const
+	{
+		if(!count)
+		{
+			return;
+		}
+
+		if(m_lifecycle.m_flags & TypeLifecycle::F_TriviallyCopyable)
+		{
+			std::memcpy(at, source, m_size * count);
+		}
+		else if(m_lifecycle.m_copyArray)
+		{
+			m_lifecycle.m_copyArray(at, source, count);
+		}
+		else
+		{
+			throw std::logic_error("TypeData::CopyArray(), type is not copy constructible");
+		}
+	}
+
+	void TypeData::AssignArray(void* at, const void* source, size_t count) const
+	{
+		if(!count)
+		{
+			return;
+		}
+
+		if(m_lifecycle.m_flags & TypeLifecycle::F_TriviallyCopyable)
+		{
+			std::memcpy(at, source, m_size * count);
+		}
+		else if(m_lifecycle.m_assignArray)
+		{
+			m_lifecycle.m_assignArray(at, source, count);
+		}
+		else
+		{
+			throw std::logic_error("TypeData::AssignArray(), type is not copy assignable");
+		}
+	}
+
+	void TypeData::RelocateArray(void* at, void* source, size_t count) const
+	{
+		if(!count)
+		{
+			return;
+		}
+
+		if(m_lifecycle.m_flags & TypeLifecycle::F_TriviallyCopyable)
+		{
+			std::memcpy(at, source, m_size * count);
+		}
+		else if(m_lifecycle.m_relocateArray)
+		{
+			m_lifecycle.m_relocateArray(at, source, count);
+		}
+		else
+		{
+			throw std::logic_error("TypeData::RelocateArray(), type is not move constructible");
+		}
 	}
 
 	Member* TypeData::GetMember(std::string name)
@@ -68,7 +351,8 @@ namespace meta
 
 }
 
-meta_declare_primitive(int);
-meta_declare_primitive(float);
-meta_declare_primitive(char);
-meta_declare_primitive(double);
\ No newline at end of file
+meta_declare_builtin(int);
+meta_declare_builtin(float);
+meta_declare_builtin(char);
+meta_declare_builtin(double);
+meta_declare_builtin(long long);
@@ -3,7 +3,25 @@
 #include "static_vector.h"
 #include <unordered_map>
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
 #include "Any.h"
+#include "Indices.h"
+#include "expression.h"
+#include "MetaUtil.h"
+#include "MetaConvert.h"
+#include "MetaInstrumentation.h"
+#include "MetaPool.h"
+#include "MetaTracing.h"
 
 #define TYPEDATA_CONTAINER_SIZE 256
 
@@ -57,6 +75,106 @@ namespace meta
 			static bool const value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
 	};
 
+	// SFINAE - determines if two T can be compared with <
+	template <typename T> class has_less_operator 
+	{
+		private:
+			template<typename U> static auto test(void*) -> decltype(std::declval<const U&>() < std::declval<const U&>(), std::true_type());
+			template<typename>   static auto test(...)   -> decltype(std::false_type());
+ 
+		public:
+			static bool const value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+	};
+
+	// SFINAE - determines if two T can be compared with ==
+	template <typename T> class has_equal_operator 
+	{
+		private:
+			template<typename U> static auto test(void*) -> decltype(std::declval<const U&>() == std::declval<const U&>(), std::true_type());
+			template<typename>   static auto test(...)   -> decltype(std::false_type());
+ 
+		public:
+			static bool const value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+	};
+
+	// SFINAE - determines if std::hash<T> is enabled
+	template <typename T> class has_std_hash 
+	{
+		private:
+			template<typename U> static auto test(void*) -> decltype(std::hash<U>()(std::declval<const U&>()), std::true_type());
+			template<typename>   static auto test(...)   -> decltype(std::false_type());
+ 
+		public:
+			static bool const value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+	};
+
+	namespace internal
+	{
+		inline size_t MixHash(size_t seed, size_t hash) { return seed ^ (hash + (size_t)0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2)); }
+
+		// The hash a registered type's lifecycle uses: std::hash<T> if it's enabled, otherwise element by element for
+		// pairs and containers of such values (std::vector, std::map, ...). Elements of unordered containers are
+		// combined independently of their order, so equal containers hash equal.
+		template <typename T, typename = void> struct value_hash 
+		{ 
+			static const bool enabled = false; 
+		};
+
+		template <typename T>
+		struct value_hash<T, typename std::enable_if<has_std_hash<T>::value>::type>
+		{
+			static const bool enabled = true;
+			static size_t Hash(const T& value) { return std::hash<T>()(value); }
+		};
+
+		template <typename A, typename B>
+		struct value_hash<std::pair<A, B>, typename std::enable_if<!has_std_hash<std::pair<A, B>>::value && 
+			value_hash<typename std::remove_const<A>::type>::enabled && value_hash<B>::enabled>::type>
+		{
+			static const bool enabled = true;
+			static size_t Hash(const std::pair<A, B>& value) 
+			{ 
+				return MixHash(value_hash<typename std::remove_const<A>::type>::Hash(value.first), value_hash<B>::Hash(value.second)); 
+			}
+		};
+
+		template <typename T, typename = void> struct is_unordered : std::false_type {};
+		template <typename T> struct is_unordered<T, decltype((void)std::declval<typename T::hasher>())> : std::true_type {};
+
+		template <typename T>
+		struct value_hash<T, typename std::enable_if<!has_std_hash<T>::value && 
+			value_hash<typename std::remove_const<typename T::value_type>::type>::enabled,
+			decltype((void)std::begin(std::declval<const T&>()), (void)std::end(std::declval<const T&>()))>::type>
+		{
+			typedef typename std::remove_const<typename T::value_type>::type Element;
+
+			static const bool enabled = true;
+			static size_t Hash(const T& value)
+			{
+				size_t hash = 0;
+				size_t count = 0;
+				for(const Element& element : value)
+				{
+					size_t elementHash = value_hash<Element>::Hash(element);
+					hash = is_unordered<T>::value ? hash + MixHash(0, elementHash) : MixHash(hash, elementHash);
+					++count;
+				}
+				return MixHash(hash, count);
+			}
+		};
+	}
+
+	// SFINAE - determines if T has a GetVersion() const, changed on every change (see pure_method())
+	template <typename T> class has_getVersion_function 
+	{
+		private:
+			template<typename U> static auto test(void*) -> decltype((uint64_t)std::declval<const U&>().GetVersion(), std::true_type());
+			template<typename>   static auto test(...)   -> decltype(std::false_type());
+ 
+		public:
+			static bool const value = std::is_same<decltype(test<T>(0)), std::true_type>::value;
+	};
+
 	//meta lookup
 	
 	template<typename T, bool HasMeta> struct meta_lookup
@@ -83,7 +201,7 @@ namespace meta
 		}
 	};
 
-	template<> struct meta_lookup<nullptr_t, false>
+	template<> struct meta_lookup<std::nullptr_t, false>
 	{
 		static const TypeData* Get()
 		{
@@ -126,8 +244,11 @@ namespace meta
 		return Get<T>();
 	}
 
-	//Get By Name
-	const TypeData* Get_Name(std::string typeName);
+	//Get By Name (fully qualified, e.g. "MetaTest::A1"). Throws std::out_of_range if no such type is registered.
+	//Names are the compiler's spelling, which for templates differs between compilers: GCC calls std::string
+	//"std::__cxx11::basic_string<char>", MSVC spells out its traits and allocator. "std::string" and "std::wstring"
+	//are accepted as aliases; for other library templates use Get<T>()->GetName() to find the spelling.
+	const TypeData* Get_Name(const std::string& typeName);
 	const TypeData* Get_Name(const char* typeName);
 
 
@@ -157,67 +278,96 @@ namespace meta
 
 	template <typename T> struct make_type_record
 	{
+		static const TypeRecord::Qualifier qualifier = TypeRecord::Q_Value;
+		static const TypeData* data() { return Get<T>(); }
+
 		static const TypeRecord type()
 		{
-			return TypeRecord(Get<T>(), TypeRecord::Q_Value);
+			return TypeRecord(data(), qualifier);
 		}
 	};
 
 	template <typename T> struct make_type_record<T*>
 	{
+		static const TypeRecord::Qualifier qualifier = TypeRecord::Q_Pointer;
+		static const TypeData* data() { return Get<T>(); }
+
 		static const TypeRecord type()
 		{
-			return TypeRecord(Get<T>(), TypeRecord::Q_Pointer);
+			return TypeRecord(data(), qualifier);
 		}
 	};
 
 	template <typename T> struct make_type_record<const T*>
 	{
+		static const TypeRecord::Qualifier qualifier = TypeRecord::Q_ConstPointer;
+		static const TypeData* data() { return Get<T>(); }
+
 		static const TypeRecord type()
 		{
-			return TypeRecord(Get<T>(), TypeRecord::Q_ConstPointer);
+			return TypeRecord(data(), qualifier);
 		}
 	};
 
 	template <typename T> struct make_type_record<T&>
 	{
+		static const TypeRecord::Qualifier qualifier = TypeRecord::Q_Reference;
+		static const TypeData* data() { return Get<T>(); }
+
 		static const TypeRecord type()
 		{
-			return TypeRecord(Get<T>(), TypeRecord::Q_Reference);
+			return TypeRecord(data(), qualifier);
 		}
 	};
 
 	template <typename T> struct make_type_record<const T&>
 	{
+		static const TypeRecord::Qualifier qualifier = TypeRecord::Q_ConstReference;
+		static const TypeData* data() { return Get<T>(); }
+
 		static const TypeRecord type()
 		{
-			return TypeRecord(Get<T>(), TypeRecord::Q_ConstReference);
+			return TypeRecord(data(), qualifier);
 		}
 	};
 
-		template <> struct make_type_record<void>
+	template <> struct make_type_record<void>
 	{
+		static const TypeRecord::Qualifier qualifier = TypeRecord::Q_Void;
+		static const TypeData* data() { return Get<void>(); }
+
 		static const TypeRecord type()
 		{
-			return TypeRecord(Get<void>(), TypeRecord::Q_Void);
+			return TypeRecord(data(), qualifier);
 		}
 	};
 
-	// Make a TypeRecord from a specific type in variadic template, specified by index
+	/*************************************************************/
+	//                      TypeDescriptor                       //
+	/*************************************************************/
 
-	template<typename... Args>
-	const TypeRecord make_type_record_byVariadicIndex(int i)
+	// Compile-time half of a TypeRecord: the qualifier, and how to look up the TypeData.
+	// Built as constexpr arrays per signature (expr::signature_descriptors), 
+	// then resolved into TypeRecords once the registry is populated.
+	struct TypeDescriptor
 	{
-		return CallFunctor_type_ByVariadicIndex<const TypeRecord, make_type_record, Args...>(i);
-	}
+		TypeRecord::Qualifier m_qualifier;
+		const TypeData* (*m_lookup)();
 
-	//overload for functions with 0 arguments.
+		constexpr TypeDescriptor() : m_qualifier(TypeRecord::Q_Void), m_lookup(nullptr) {}
+		constexpr TypeDescriptor(TypeRecord::Qualifier qualifier, const TypeData* (*lookup)()) : m_qualifier(qualifier), m_lookup(lookup) {}
 
-	template<>
-	inline const TypeRecord make_type_record_byVariadicIndex<>(int i)
-	{
-		return TypeRecord(Get<void>(), TypeRecord::Qualifier::Q_Void);
-	}
+		template <typename T>
+		static constexpr TypeDescriptor make()
+		{
+			return TypeDescriptor(make_type_record<T>::qualifier, &make_type_record<T>::data);
+		}
+
+		TypeRecord Resolve() const
+		{
+			return m_lookup ? TypeRecord(m_lookup(), m_qualifier) : make_type_record<void>::type();
+		}
+	};
 
 	/*****************************************************/
 	//                      Member                       //
@@ -229,20 +379,51 @@ namespace meta
 		const TypeData* m_owner;
 		const TypeData* m_type;
 
+		// Looks the type up on use, it may be registered by a static initializer that runs after this member's.
+		const TypeData* (*m_typeLookup)();
+
+		// As in TypeRecord: a pointer member's type is its pointee's.
+		TypeRecord::Qualifier m_qualifier;
+
+		// Layout within the owner. Size and alignment are the member's own, known even before its TypeData is registered.
+		size_t m_offset;
+		size_t m_size;
+		size_t m_alignment;
+
 	public:
-		Member() : m_name(""), m_type(nullptr) {}
-		Member(const char* name, const TypeData* type) : m_name(name), m_type(type) {}
+		Member() : m_name(""), m_owner(nullptr), m_type(nullptr), m_typeLookup(nullptr), m_qualifier(TypeRecord::Q_Value), m_offset(0), m_size(0), m_alignment(1) {}
+		Member(const char* name, const TypeData* type) : m_name(name), m_owner(nullptr), m_type(type), m_typeLookup(nullptr), m_qualifier(TypeRecord::Q_Value), m_offset(0), m_size(0), m_alignment(1) {}
+		Member(const char* name, const TypeData* (*typeLookup)(), TypeRecord::Qualifier qualifier, size_t offset, size_t size, size_t alignment) : 
+			m_name(name), 
+			m_owner(nullptr), 
+			m_type(nullptr), 
+			m_typeLookup(typeLookup),
+			m_qualifier(qualifier),
+			m_offset(offset), 
+			m_size(size), 
+			m_alignment(alignment) 
+		{}
 		
 		Member(const Member& mem) :
 			m_name(mem.m_name), 
 			m_owner(mem.m_owner), 
-			m_type(mem.m_type) 
+			m_type(mem.m_type),
+			m_typeLookup(mem.m_typeLookup),
+			m_qualifier(mem.m_qualifier),
+			m_offset(mem.m_offset),
+			m_size(mem.m_size),
+			m_alignment(mem.m_alignment)
 		{}
 
 		Member(Member&& mem) : 
 			m_name(mem.m_name), 
 			m_owner(mem.m_owner), 
-			m_type(mem.m_type) 
+			m_type(mem.m_type),
+			m_typeLookup(mem.m_typeLookup),
+			m_qualifier(mem.m_qualifier),
+			m_offset(mem.m_offset),
+			m_size(mem.m_size),
+			m_alignment(mem.m_alignment)
 		{
 			mem.m_name = "";
 			mem.m_owner = nullptr;
@@ -251,9 +432,15 @@ namespace meta
 		~Member() {}
 
 		void SetOwner(TypeData* owner) { m_owner = owner; }
-		const TypeData* GetOwner() { return m_owner; }
+		const TypeData* GetOwner() const { return m_owner; }
+
+		const TypeData* GetType() const { return m_typeLookup ? m_typeLookup() : m_type; }
+		TypeRecord::Qualifier GetQualifier() const { return m_qualifier; }
+		TypeRecord GetTypeRecord() const { return TypeRecord(GetType(), m_qualifier); }
+		bool IsPointer() const { return m_qualifier == TypeRecord::Q_Pointer || m_qualifier == TypeRecord::Q_ConstPointer; }
 
-		const TypeData* GetType() const { return m_type; }
+		// The type of the member's own bytes: GetType() for values, a raw pointer type for pointers.
+		const TypeData* GetStorageType() const;
 
 		const char* GetTypeName() const;
 		std::string GetTypeNameStr() const;
@@ -261,7 +448,14 @@ namespace meta
 		const char* GetName() const { return m_name; }
 		std::string GetNameStr() const { return std::string(m_name); }
 
-		size_t GetSize();
+		size_t GetSize() const { return m_size; }
+		size_t GetAlignment() const { return m_alignment; }
+
+		// Byte offset from the start of the owner.
+		size_t GetOffset() const { return m_offset; }
+
+		void*       GetPointer(void* instance) const             { return static_cast<char*>(instance) + m_offset; }
+		const void* GetPointer(const void* instance) const { return static_cast<const char*>(instance) + m_offset; }
 	};
 
 
@@ -277,38 +471,336 @@ namespace meta
 		const char* m_name;
 		TypeData* m_owner;
 
+		// Signature descriptors, constant-initialized per signature by the concrete method.
+		const TypeDescriptor* m_paramDescs;
+		TypeDescriptor m_returnDesc;
+		unsigned int m_arity;
+
+		// TypeRecords resolved from the descriptors on first use.
+		// Deferred because parameter types may be registered by static initializers that haven't run yet.
+		mutable std::vector<TypeRecord> m_paramTypes;
+		mutable TypeRecord m_returnType;
+		mutable std::atomic<bool> m_resolved;
+
+	#if META_INSTRUMENTATION
+		unsigned int m_statsIndex;
+
+		void RegisterStats() { m_statsIndex = instrumentation::internal::RegisterMethod(this); }
+	#else
+		void RegisterStats() {}
+	#endif
+
+		void ResolveSignature() const;
+
 	public:
-		Method() : m_name("") {}
-		Method(const char* name) : m_name(name) {}
-		Method(const Method& mem) : m_name(mem.m_name), m_owner(mem.m_owner)
+		Method() : m_name(""), m_owner(nullptr), m_paramDescs(nullptr), m_arity(0), m_resolved(false) { RegisterStats(); }
+		Method(const char* name) : m_name(name), m_owner(nullptr), m_paramDescs(nullptr), m_arity(0), m_resolved(false) { RegisterStats(); }
+
+		Method(const char* name, const TypeDescriptor* paramDescs, unsigned int arity, TypeDescriptor returnDesc) :
+			m_name(name),
+			m_owner(nullptr),
+			m_paramDescs(paramDescs),
+			m_returnDesc(returnDesc),
+			m_arity(arity),
+			m_paramTypes(arity),
+			m_resolved(false)
+		{
+			RegisterStats();
+		}
+
+		Method(const Method& mem) : 
+			m_name(mem.m_name), 
+			m_owner(mem.m_owner),
+			m_paramDescs(mem.m_paramDescs),
+			m_returnDesc(mem.m_returnDesc),
+			m_arity(mem.m_arity),
+			m_paramTypes(mem.m_arity),
+			m_resolved(false)
+		#if META_INSTRUMENTATION
+			, m_statsIndex(mem.m_statsIndex)
+		#endif
 		{}
 
 		Method(Method&& mem) :
 			m_name(mem.m_name),
-			m_owner(mem.m_owner)
+			m_owner(mem.m_owner),
+			m_paramDescs(mem.m_paramDescs),
+			m_returnDesc(mem.m_returnDesc),
+			m_arity(mem.m_arity),
+			m_paramTypes(mem.m_arity),
+			m_resolved(false)
+		#if META_INSTRUMENTATION
+			, m_statsIndex(mem.m_statsIndex)
+		#endif
 		{
 			mem.m_name = "";
 			mem.m_owner = nullptr;
 		}
 
-		~Method() {}
+		virtual ~Method() {}
 
 		void SetOwner(TypeData* owner) { m_owner = owner; }
 		TypeData* GetOwner() { return m_owner; }
+		const TypeData* GetOwner() const { return m_owner; }
 
 		const char* GetName() const { return m_name; }
 		std::string GetNameStr() const { return std::string(m_name); }
 
-		virtual int GetArity() const = 0;
-		virtual TypeRecord GetReturnType() const = 0;
-		virtual TypeRecord GetParamType(unsigned int i) const = 0;
+	#if META_INSTRUMENTATION
+		// Index of this method's counters, see MetaInstrumentation.h
+		unsigned int GetStatsIndex() const { return m_statsIndex; }
+	#endif
+
+		int GetArity() const { return m_arity; }
+
+		// Array of GetArity() TypeRecords. Meant for overload resolution and argument validation loops.
+		const TypeRecord* GetParamTypes() const
+		{
+			if(!m_resolved.load(std::memory_order_acquire))
+			{
+				ResolveSignature();
+			}
+			return m_paramTypes.data();
+		}
+
+		TypeRecord GetReturnType() const
+		{
+			if(!m_resolved.load(std::memory_order_acquire))
+			{
+				ResolveSignature();
+			}
+			return m_returnType;
+		}
+
+		TypeRecord GetParamType(unsigned int i) const
+		{
+			//overload for functions with 0 arguments.
+			if(m_arity == 0)
+			{
+				return make_type_record<void>::type();
+			}
+
+			if(i >= m_arity)
+			{
+				throw std::range_error("type index out of range");
+			}
+
+			return GetParamTypes()[i];
+		}
 
 		//Call()
 		//CanCall()
 
+		// Calls the method on obj with the arguments in argv, which it consumes: arguments for by-value and T&&
+		// parameters are moved out of their anys, and mismatched ones are first overwritten with their conversions
+		// to the parameter types. Reusing argv for a second call passes those moved-from values; rebuild it, or
+		// copy it first, to call again with the same arguments. Arguments for const T& and T& parameters are left
+		// as they are (apart from conversion). Invoke() builds a fresh argv per call.
 		virtual Any DoCall(Any& obj, Any* argv) const = 0;
+
+		// Calls like DoCall(), but constructs the result in place at result: uninitialized storage for the return type
+		// without its reference (a method returning const std::string& fills a std::string). Values the method
+		// returns by value are constructed there directly, with no Any and no copy. Nothing is written for void.
+		virtual void DoCallInto(Any& obj, Any* argv, void* result) const = 0;
+
+		// Identifies the type DoCallInto() constructs, as the policy of an Any holding one.
+		virtual const anyimpl::base_any_policy* GetResultPolicy() const = 0;
+	};
+
+
+
+	/*****************************************************/
+	//                   TypeLifecycle                   //
+	/*****************************************************/
+
+	// A type's special members, type-erased. Null where the type doesn't have one.
+	struct TypeLifecycle
+	{
+		// Type traits detected at registration. With the first three, TypeData's array functions use memset, memcpy or nothing instead of the thunks.
+		enum Flags
+		{
+			F_ZeroConstructible = 1 << 0,	// T() is all zero bytes
+			F_TriviallyDestructible = 1 << 1,
+			F_TriviallyCopyable = 1 << 2,	// copies, moves and relocations are memcpy
+			F_StandardLayout = 1 << 3,
+			F_Polymorphic = 1 << 4	// has a vtable pointer
+		};
+
+		void (*m_construct)(void* at);
+		void (*m_destruct)(void* instance);
+		void (*m_copyConstruct)(void* at, const void* source);
+		void (*m_moveConstruct)(void* at, void* source);
+
+		// Loops over count elements. On an exception, already constructed elements are destroyed.
+		void (*m_constructArray)(void* at, size_t count);
+		void (*m_destructArray)(void* at, size_t count);
+		void (*m_copyArray)(void* at, const void* source, size_t count);
+		void (*m_assignArray)(void* at, const void* source, size_t count);	// copy assigns to live objects
+		void (*m_relocateArray)(void* at, void* source, size_t count);	// move constructs, then destroys the source
+
+		bool (*m_less)(const void* a, const void* b);	// operator<
+		bool (*m_equal)(const void* a, const void* b);	// operator==
+		size_t (*m_hash)(const void* instance);			// std::hash, or element-wise for containers (internal::value_hash)
+
+		const TypeData* (*m_dynamicType)(const void* instance);	// GetType() of types with meta_declare
+		const void* (*m_mostDerived)(const void* instance);		// dynamic_cast<const void*> of polymorphic types
+
+		unsigned int m_flags;
 	};
 
+	namespace internal
+	{
+		template <typename T> void ConstructThunk(void* at) { new (at) T(); }
+		template <typename T> void DestructThunk(void* instance) { static_cast<T*>(instance)->~T(); }
+		template <typename T> void CopyConstructThunk(void* at, const void* source) { new (at) T(*static_cast<const T*>(source)); }
+		template <typename T> void MoveConstructThunk(void* at, void* source) { new (at) T(std::move(*static_cast<T*>(source))); }
+
+		template <typename T> bool LessThunk(const void* a, const void* b) { return *static_cast<const T*>(a) < *static_cast<const T*>(b); }
+		template <typename T> bool EqualThunk(const void* a, const void* b) { return *static_cast<const T*>(a) == *static_cast<const T*>(b); }
+		template <typename T> size_t HashThunk(const void* instance) { return value_hash<T>::Hash(*static_cast<const T*>(instance)); }
+		template <typename T> const TypeData* DynamicTypeThunk(const void* instance) { return static_cast<const T*>(instance)->GetType(); }
+		template <typename T> const void* MostDerivedThunk(const void* instance) { return dynamic_cast<const void*>(static_cast<const T*>(instance)); }
+
+		template <typename T> void DestructArrayThunk(void* at, size_t count)
+		{
+			T* objects = static_cast<T*>(at);
+			for(size_t i = 0; i < count; ++i)
+			{
+				objects[i].~T();
+			}
+		}
+
+		template <typename T> void ConstructArrayThunk(void* at, size_t count)
+		{
+			T* objects = static_cast<T*>(at);
+			size_t i = 0;
+			try
+			{
+				for(; i < count; ++i)
+				{
+					new (objects + i) T();
+				}
+			}
+			catch(...)
+			{
+				DestructArrayThunk<T>(objects, i);
+				throw;
+			}
+		}
+
+		template <typename T> void CopyArrayThunk(void* at, const void* source, size_t count)
+		{
+			T* objects = static_cast<T*>(at);
+			const T* sources = static_cast<const T*>(source);
+			size_t i = 0;
+			try
+			{
+				for(; i < count; ++i)
+				{
+					new (objects + i) T(sources[i]);
+				}
+			}
+			catch(...)
+			{
+				DestructArrayThunk<T>(objects, i);
+				throw;
+			}
+		}
+
+		template <typename T> void AssignArrayThunk(void* at, const void* source, size_t count)
+		{
+			T* objects = static_cast<T*>(at);
+			const T* sources = static_cast<const T*>(source);
+			for(size_t i = 0; i < count; ++i)
+			{
+				objects[i] = sources[i];
+			}
+		}
+
+		template <typename T> void RelocateArrayThunk(void* at, void* source, size_t count)
+		{
+			T* objects = static_cast<T*>(at);
+			T* sources = static_cast<T*>(source);
+			size_t i = 0;
+			try
+			{
+				for(; i < count; ++i)
+				{
+					new (objects + i) T(std::move(sources[i]));
+				}
+			}
+			catch(...)
+			{
+				DestructArrayThunk<T>(objects, i);
+				throw;
+			}
+			DestructArrayThunk<T>(sources, count);
+		}
+
+		// Only the chosen overload is instantiated, so thunks are never compiled for types lacking the special member.
+		template <typename T> constexpr void (*ConstructThunkIf(std::true_type))(void*) { return &ConstructThunk<T>; }
+		template <typename T> constexpr void (*ConstructThunkIf(std::false_type))(void*) { return nullptr; }
+		template <typename T> constexpr void (*DestructThunkIf(std::true_type))(void*) { return &DestructThunk<T>; }
+		template <typename T> constexpr void (*DestructThunkIf(std::false_type))(void*) { return nullptr; }
+		template <typename T> constexpr void (*CopyConstructThunkIf(std::true_type))(void*, const void*) { return &CopyConstructThunk<T>; }
+		template <typename T> constexpr void (*CopyConstructThunkIf(std::false_type))(void*, const void*) { return nullptr; }
+		template <typename T> constexpr void (*MoveConstructThunkIf(std::true_type))(void*, void*) { return &MoveConstructThunk<T>; }
+		template <typename T> constexpr void (*MoveConstructThunkIf(std::false_type))(void*, void*) { return nullptr; }
+		template <typename T> constexpr void (*ConstructArrayThunkIf(std::true_type))(void*, size_t) { return &ConstructArrayThunk<T>; }
+		template <typename T> constexpr void (*ConstructArrayThunkIf(std::false_type))(void*, size_t) { return nullptr; }
+		template <typename T> constexpr void (*DestructArrayThunkIf(std::true_type))(void*, size_t) { return &DestructArrayThunk<T>; }
+		template <typename T> constexpr void (*DestructArrayThunkIf(std::false_type))(void*, size_t) { return nullptr; }
+		template <typename T> constexpr void (*CopyArrayThunkIf(std::true_type))(void*, const void*, size_t) { return &CopyArrayThunk<T>; }
+		template <typename T> constexpr void (*CopyArrayThunkIf(std::false_type))(void*, const void*, size_t) { return nullptr; }
+		template <typename T> constexpr void (*AssignArrayThunkIf(std::true_type))(void*, const void*, size_t) { return &AssignArrayThunk<T>; }
+		template <typename T> constexpr void (*AssignArrayThunkIf(std::false_type))(void*, const void*, size_t) { return nullptr; }
+		template <typename T> constexpr void (*RelocateArrayThunkIf(std::true_type))(void*, void*, size_t) { return &RelocateArrayThunk<T>; }
+		template <typename T> constexpr void (*RelocateArrayThunkIf(std::false_type))(void*, void*, size_t) { return nullptr; }
+		template <typename T> constexpr bool (*LessThunkIf(std::true_type))(const void*, const void*) { return &LessThunk<T>; }
+		template <typename T> constexpr bool (*LessThunkIf(std::false_type))(const void*, const void*) { return nullptr; }
+		template <typename T> constexpr bool (*EqualThunkIf(std::true_type))(const void*, const void*) { return &EqualThunk<T>; }
+		template <typename T> constexpr bool (*EqualThunkIf(std::false_type))(const void*, const void*) { return nullptr; }
+		template <typename T> constexpr size_t (*HashThunkIf(std::true_type))(const void*) { return &HashThunk<T>; }
+		template <typename T> constexpr size_t (*HashThunkIf(std::false_type))(const void*) { return nullptr; }
+		template <typename T> constexpr const TypeData* (*DynamicTypeThunkIf(std::true_type))(const void*) { return &DynamicTypeThunk<T>; }
+		template <typename T> constexpr const TypeData* (*DynamicTypeThunkIf(std::false_type))(const void*) { return nullptr; }
+		template <typename T> constexpr const void* (*MostDerivedThunkIf(std::true_type))(const void*) { return &MostDerivedThunk<T>; }
+		template <typename T> constexpr const void* (*MostDerivedThunkIf(std::false_type))(const void*) { return nullptr; }
+
+		// Member pointers are the usual exception to zero bytes meaning value initialized.
+		template <typename T>
+		constexpr unsigned int LifecycleFlags()
+		{
+			return 
+				(std::is_trivially_default_constructible<T>::value && !std::is_member_pointer<T>::value ? TypeLifecycle::F_ZeroConstructible : 0) |
+				(std::is_trivially_destructible<T>::value ? TypeLifecycle::F_TriviallyDestructible : 0) |
+				(std::is_trivially_copyable<T>::value ? TypeLifecycle::F_TriviallyCopyable : 0) |
+				(std::is_standard_layout<T>::value ? TypeLifecycle::F_StandardLayout : 0) |
+				(std::is_polymorphic<T>::value ? TypeLifecycle::F_Polymorphic : 0);
+		}
+
+		template <typename T>
+		constexpr TypeLifecycle MakeLifecycle()
+		{
+			return TypeLifecycle{
+				ConstructThunkIf<T>(std::is_default_constructible<T>()),
+				DestructThunkIf<T>(std::is_destructible<T>()),
+				CopyConstructThunkIf<T>(std::is_copy_constructible<T>()),
+				MoveConstructThunkIf<T>(std::is_move_constructible<T>()),
+				ConstructArrayThunkIf<T>(std::is_default_constructible<T>()),
+				DestructArrayThunkIf<T>(std::is_destructible<T>()),
+				CopyArrayThunkIf<T>(std::is_copy_constructible<T>()),
+				AssignArrayThunkIf<T>(std::is_copy_assignable<T>()),
+				RelocateArrayThunkIf<T>(std::integral_constant<bool, std::is_move_constructible<T>::value && std::is_destructible<T>::value>()),
+				LessThunkIf<T>(std::integral_constant<bool, has_less_operator<T>::value>()),
+				EqualThunkIf<T>(std::integral_constant<bool, has_equal_operator<T>::value>()),
+				HashThunkIf<T>(std::integral_constant<bool, value_hash<T>::enabled>()),
+				DynamicTypeThunkIf<T>(std::integral_constant<bool, has_getType_function<T>::value>()),
+				MostDerivedThunkIf<T>(std::is_polymorphic<T>()),
+				LifecycleFlags<T>() };
+		}
+	}
+
 
 
 	/*****************************************************/
@@ -319,11 +811,31 @@ namespace meta
 	{
 	private:
 		const char* m_name;
+		uint64_t m_nameHash;
 		size_t m_size;
+		size_t m_alignment;
+		TypeLifecycle m_lifecycle;
+
+		// Create()/Destroy() allocate from here. Made by the first Create*(), so types that are never created don't
+		// get one. Shared by copies made after that, never freed.
+		mutable std::atomic<internal::SlabPool*> m_pool;
+
+		// Null for types without a size.
+		internal::SlabPool* GetPool() const;
+
+		// Indexes the last stored TypeData by its name hash. 
+		static unsigned int IndexLastTypeData()
+		{
+			unsigned int lastIndex = s_TypeDataStorage.size() - 1;
+			bool inserted = sTypeDictionary.insert( std::make_pair(s_TypeDataStorage[lastIndex].m_nameHash, lastIndex) ).second;
+			assert(inserted && "TypeData registered twice, or two type names hash the same.");
+			(void)inserted;
+			return lastIndex;
+		}
 
 	protected:
 		static static_vector<TypeData> s_TypeDataStorage;
-		static std::unordered_map<std::string, unsigned int> sTypeDictionary;
+		static std::unordered_map<uint64_t, unsigned int> sTypeDictionary;
 		std::vector<Member*> m_members;
 		std::vector<Method*> m_methods;
 
@@ -337,7 +849,8 @@ namespace meta
 			return &s_TypeDataStorage;
 		}
 
-		static const std::unordered_map<std::string, unsigned int>* GetTypeDataDictionary()
+		// Keyed by TypeData::GetNameHash()
+		static const std::unordered_map<uint64_t, unsigned int>* GetTypeDataDictionary()
 		{
 			return &sTypeDictionary;
 		}
@@ -348,10 +861,7 @@ namespace meta
 
 			s_TypeDataStorage.emplace_back(name, size);
 
-			unsigned int lastIndex = s_TypeDataStorage.size() - 1;
-			sTypeDictionary.insert( std::make_pair(name, lastIndex) );
-
-			return lastIndex;
+			return IndexLastTypeData();
 		}
 
 		static int AddTypeData(const TypeData& rhs)
@@ -360,10 +870,7 @@ namespace meta
 
 			s_TypeDataStorage.emplace_back(rhs);
 
-			unsigned int lastIndex = s_TypeDataStorage.size() - 1;
-			sTypeDictionary.insert( std::make_pair(rhs.m_name, lastIndex) );
-
-			return lastIndex;
+			return IndexLastTypeData();
 		}
 
 		static int AddTypeData(TypeData&& rhs)
@@ -372,24 +879,60 @@ namespace meta
 
 			assert(s_TypeDataStorage.size() <= TYPEDATA_CONTAINER_SIZE);
 
-			unsigned int lastIndex = s_TypeDataStorage.size() - 1;
-			sTypeDictionary.insert( std::make_pair(s_TypeDataStorage[lastIndex].m_name, lastIndex) );
-
-			return lastIndex;
+			return IndexLastTypeData();
 		}
 
 		//Constructors
 		
-		TypeData() : m_name(""), m_size(0) {}
+		TypeData() : m_name(""), m_nameHash(internal::HashName("")), m_size(0), m_alignment(1), m_lifecycle(), m_pool(nullptr) {}
 		
+		// For names only known at runtime. Types registered through the macros use the compile time name and hash.
+		// Without a lifecycle these can't Create() instances.
 		TypeData(const char* name, size_t size) : 
 			m_name(name), 
-			m_size(size) 
+			m_nameHash(internal::HashName(name)),
+			m_size(size),
+			m_alignment(alignof(std::max_align_t)),
+			m_lifecycle(),
+			m_pool(nullptr)
+		{}
+
+		TypeData(const char* name, uint64_t nameHash, size_t size) : 
+			m_name(name), 
+			m_nameHash(nameHash),
+			m_size(size),
+			m_alignment(alignof(std::max_align_t)),
+			m_lifecycle(),
+			m_pool(nullptr)
+		{}
+
+		TypeData(const char* name, uint64_t nameHash, size_t size, size_t alignment, const TypeLifecycle& lifecycle) : 
+			m_name(name), 
+			m_nameHash(nameHash),
+			m_size(size),
+			m_alignment(alignment),
+			m_lifecycle(lifecycle),
+			m_pool(nullptr)
 		{}
 		
+		TypeData(const TypeData& rhs) : 
+			m_name(rhs.m_name), 
+			m_nameHash(rhs.m_nameHash),
+			m_size(rhs.m_size), 
+			m_alignment(rhs.m_alignment),
+			m_lifecycle(rhs.m_lifecycle),
+			m_pool(rhs.m_pool.load(std::memory_order_acquire)),
+			m_members(rhs.m_members), 
+			m_methods(rhs.m_methods) 
+		{}
+
 		TypeData(TypeData&& rhs) : 
 			m_name(rhs.m_name), 
+			m_nameHash(rhs.m_nameHash),
 			m_size(rhs.m_size), 
+			m_alignment(rhs.m_alignment),
+			m_lifecycle(rhs.m_lifecycle),
+			m_pool(rhs.m_pool.load(std::memory_order_acquire)),
 			m_members(rhs.m_members), 
 			m_methods(rhs.m_methods) 
 		{
@@ -405,8 +948,33 @@ namespace meta
 
 		const char* GetName() const { return m_name; }
 		std::string GetNameStr() const { return std::string(m_name); }
+		uint64_t GetNameHash() const { return m_nameHash; }
 
 		size_t GetSize() const { return m_size; }
+		size_t GetAlignment() const { return m_alignment; }
+		const TypeLifecycle& GetLifecycle() const { return m_lifecycle; }
+		unsigned int GetFlags() const { return m_lifecycle.m_flags; }
+
+		// Default constructs an instance in this type's pool. Throws std::logic_error if the type can't be.
+		void* Create() const;
+		void* CreateCopy(const void* source) const;
+		void* CreateMove(void* source) const;
+
+		// Destroys and frees an instance from Create*(). Must be the TypeData of the instance's dynamic type.
+		void Destroy(void* instance) const;
+
+		// Placement lifecycle of count contiguous objects in caller memory, aligned for GetAlignment().
+		// Throw std::logic_error if the type lacks the special member.
+		void ConstructArray(void* at, size_t count) const;
+		void DestroyArray(void* at, size_t count) const;
+		void CopyArray(void* at, const void* source, size_t count) const;
+		// Copy assigns source to count live objects at. If an assignment throws, every object is still alive.
+		void AssignArray(void* at, const void* source, size_t count) const;
+		// Moves count objects to uninitialized memory at, and ends the lifetime of the sources. The ranges can't overlap.
+		void RelocateArray(void* at, void* source, size_t count) const;
+
+		void Construct(void* at) const { ConstructArray(at, 1); }
+		void Destruct(void* instance) const { DestroyArray(instance, 1); }
 
 		std::vector<Member*>&       GetMembers()       { return m_members; }
 		const std::vector<Member*>& GetMembers() const { return m_members; }
@@ -474,6 +1042,15 @@ namespace meta
 		//                 ConcreteMember                 //
 		/**************************************************/
 
+		// Offset of a data member, found through uninitialized storage (no object is constructed).
+		template<typename Object, typename T>
+		size_t MemberOffset(T Object::*memberVar)
+		{
+			alignas(Object) static unsigned char s_storage[sizeof(Object)];
+			const Object* object = reinterpret_cast<const Object*>(s_storage);
+			return reinterpret_cast<const unsigned char*>(&(object->*memberVar)) - s_storage;
+		}
+
 		template<typename Object, typename T>
 		class ConcreteMember : public Member
 		{
@@ -481,166 +1058,518 @@ namespace meta
 			T Object::*m_memberPtr;
 
 		public:
-			ConcreteMember(const char* name, const TypeData* T_data, T Object::*memberVar) :
-				Member(name, T_data),
+			ConcreteMember(const char* name, T Object::*memberVar) :
+				Member(name, &make_type_record<T>::data, make_type_record<T>::qualifier, MemberOffset(memberVar), sizeof(T), alignof(T)),
 				m_memberPtr(memberVar)
 			{}
 		};
 
 
 		/***************************************************************/
-		//                 VerMethod (Concrete Method)                 //
+		//                         MethodTraits                        //
 		/***************************************************************/
-		
-		template<typename ReturnT, typename Object, bool isConst, typename... Args>
-		class MethodPtr
+
+		// Gets the object a method is called on. obj holds either the object itself, or a pointer to it.
+		template<typename Object>
+		Object* GetReceiver(Any& obj)
+		{
+			if(obj.is<Object*>())
+			{
+				return obj.cast<Object*>();
+			}
+			return obj.getPointer<Object>();
+		}
+
+		// Const methods can also be called through a const pointer. A receiver held by value is read in place,
+		// so a shared one isn't copied out.
+		template<typename Object>
+		const Object* GetConstReceiver(Any& obj)
+		{
+			if(obj.is<const Object*>())
+			{
+				return obj.cast<const Object*>();
+			}
+			if(obj.is<Object*>())
+			{
+				return obj.cast<Object*>();
+			}
+			return &static_cast<const Any&>(obj).cast<Object>();
+		}
+
+		// Pulls an argument out of its Any with the value category of the parameter:
+		// const T& reads the stored value in place (a shared payload stays shared), T& binds to it,
+		// and T and T&& are moved out of it.
+		template<typename Arg>
+		Arg&& UnpackArg(Any& arg, std::true_type /*isConst*/)
+		{
+			return static_cast<Arg&&>(static_cast<const Any&>(arg).cast<typename Remove_Ptr_Ref<Arg>::type>());
+		}
+
+		template<typename Arg>
+		Arg&& UnpackArg(Any& arg, std::false_type /*isConst*/)
+		{
+			return static_cast<Arg&&>(*arg.getPointer<typename Remove_Ptr_Ref<Arg>::type>());
+		}
+
+		template<typename Arg>
+		Arg&& UnpackArg(Any& arg)
 		{
+			return UnpackArg<Arg>(arg, std::is_const<typename std::remove_reference<Arg>::type>());
+		}
+
+		// Decomposes anything that can be registered as a method into its Object, ReturnT and Args,
+		// and knows how to call it. Object is void for free functions and callables, which ignore obj.
+		template<typename F, typename Enable = void>
+		struct method_traits;
+
+		#define META_METHOD_TRAITS(QUALIFIERS, IS_CONST, RECEIVER)								\
+		template<typename Ret, typename Obj, typename... Args>									\
+		struct method_traits<Ret(Obj::*)(Args...) QUALIFIERS>									\
+		{																						\
+			typedef Ret ReturnT;																\
+			typedef Obj Object;																	\
+			typedef expr::detail::type_pack<Args...> ArgsPack;									\
+			static const bool isConst = IS_CONST;												\
+																								\
+			static Ret Invoke(Ret(Obj::*method)(Args...) QUALIFIERS, Any& obj, Args&&... args)	\
+			{																					\
+				return (RECEIVER.*method)(std::forward<Args>(args)...);						\
+			}																					\
 		};
 
-		template<typename ReturnT, typename Object, typename... Args>
-		class MethodPtr<ReturnT, Object, false, Args...>
+		META_METHOD_TRAITS(, false, (*GetReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(&, false, (*GetReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(&&, false, std::move(*GetReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(const, true, (*GetConstReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(const &, true, (*GetConstReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(const &&, true, std::move(*GetConstReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(noexcept, false, (*GetReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(& noexcept, false, (*GetReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(&& noexcept, false, std::move(*GetReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(const noexcept, true, (*GetConstReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(const & noexcept, true, (*GetConstReceiver<Obj>(obj)))
+		META_METHOD_TRAITS(const && noexcept, true, std::move(*GetConstReceiver<Obj>(obj)))
+
+		#undef META_METHOD_TRAITS
+
+		// Free functions (static methods)
+		template<typename Ret, typename... Args>
+		struct method_traits<Ret(*)(Args...)>
 		{
-		public:
-			typedef ReturnT(Object::*MethodPointerT)(Args...);
+			typedef Ret ReturnT;
+			typedef void Object;
+			typedef expr::detail::type_pack<Args...> ArgsPack;
+			static const bool isConst = true;
+
+			static Ret Invoke(Ret(*function)(Args...), Any& /*obj*/, Args&&... args)
+			{
+				return function(std::forward<Args>(args)...);
+			}
 		};
 
-		template<typename ReturnT, typename Object, typename... Args>
-		class MethodPtr<ReturnT, Object, true, Args...>
+		template<typename Ret, typename... Args>
+		struct method_traits<Ret(*)(Args...) noexcept> : method_traits<Ret(*)(Args...)>
 		{
-		public:
-			typedef ReturnT(Object::*MethodPointerT)(Args...) const;
 		};
-		
-		//This expands the array of Any objects, casts them to thier appropriate types, and sends them as arguements to the member function.
-		//Note indicesT is only there because it separates the Is and Args parameter packs. This cannot work with a struct without a wrapper like tuple to hold the packs.
-		template<typename ObjectT, typename ReturnT, unsigned int... Is, template <unsigned int...> class indicesT, typename... Args>
-		ReturnT Call_Internal(ReturnT(ObjectT::*method)(Args...), ObjectT* obj, Any* argv, indicesT<Is...> indices)
+
+		// Callables (lambdas, functors). Called as const, so mutable lambdas are not supported.
+		template<typename F, typename Pack>
+		struct callable_invoker;
+
+		template<typename F, typename... Args>
+		struct callable_invoker<F, expr::detail::type_pack<Args...>>
 		{
-			return (obj->*method)(*argv[Is].getPointer<Args>()...);
-		}
+			static auto Invoke(const F& callable, Any& /*obj*/, Args&&... args) -> decltype(callable(std::forward<Args>(args)...))
+			{
+				return callable(std::forward<Args>(args)...);
+			}
+		};
 
-		//This creates the indices trick, to create a pack of indices for referencing the elements in the argv array.
-		template <typename ObjectT, typename ReturnT, typename... Args>
-		ReturnT Call(ReturnT(ObjectT::*method)(Args...), ObjectT* obj, Any* argv)
+		template<typename F>
+		struct method_traits<F, typename std::enable_if<std::is_class<F>::value, decltype((void)&F::operator())>::type> :
+			callable_invoker<F, typename method_traits<decltype(&F::operator())>::ArgsPack>
 		{
-			assert((sizeof...(Args) >  0 && argv != nullptr) ||		        // if has args, must not have null argv.
-					(sizeof...(Args) == 0 && argv == nullptr)    );			// if no args, must have null argv.
-			return Call_Internal(method, obj, argv, toIndices(build_indices<sizeof...(Args)>{}));
-		}
+			typedef typename method_traits<decltype(&F::operator())>::ReturnT ReturnT;
+			typedef void Object;
+			typedef typename method_traits<decltype(&F::operator())>::ArgsPack ArgsPack;
+			static const bool isConst = true;
+		};
 
-		// CONST METHODS //
+		/***************************************************************/
+		//                 VarMethod (Concrete Method)                 //
+		/***************************************************************/
 
-		template<typename ObjectT, typename ReturnT, unsigned int... Is, template <unsigned int...> class indicesT, typename... Args>
-		ReturnT Call_Internal(ReturnT(ObjectT::*method)(Args...) const, ObjectT* obj, Any* argv, indicesT<Is...> indices)
+		// Calls the F stored at method. The only code each registered method adds; the rest of VarMethod is shared
+		// by every method of the same shape.
+		template<typename F, typename ReturnT, typename... Args>
+		ReturnT CallStub(const void* method, Any& obj, Args&&... args)
 		{
-			return (obj->*method)(*argv[Is].getPointer<Args>()...);
+			return method_traits<F>::Invoke(*static_cast<const F*>(method), obj, std::forward<Args>(args)...);
 		}
 
-		//This creates the indices trick, to create a pack of indices for referencing the elements in the argv array.
-		template <typename ObjectT, typename ReturnT, typename... Args>
-		ReturnT Call(ReturnT(ObjectT::*method)(Args...) const, ObjectT* obj, Any* argv)
+		template<typename F>
+		void DeleteStub(void* method)
 		{
-			assert((sizeof...(Args) >  0 && argv != nullptr) ||		        // if has args, must not have null argv.
-					(sizeof...(Args) == 0 && argv == nullptr)    );			// if no args, must have null argv.
-			return Call_Internal(method, obj, argv, toIndices(build_indices<sizeof...(Args)>{}));
+			delete static_cast<F*>(method);
 		}
-		
+
+		// Where a VarMethod keeps its F. Member function pointers, function pointers and captureless lambdas
+		// are kept in place; other callables on the heap.
+		class MethodStorage
+		{
+			static const size_t c_inPlaceSize = 4 * sizeof(void*);
+
+			alignas(std::max_align_t) unsigned char m_inPlace[c_inPlaceSize];
+			void* m_heap;
+			void (*m_delete)(void*);
+
+		public:
+			template<typename F, typename std::enable_if<(sizeof(F) <= c_inPlaceSize && alignof(F) <= alignof(std::max_align_t) && 
+				std::is_trivially_copyable<F>::value), int>::type = 0>
+			explicit MethodStorage(const F& method) : m_heap(nullptr), m_delete(nullptr)
+			{
+				new (m_inPlace) F(method);
+			}
+
+			template<typename F, typename std::enable_if<!(sizeof(F) <= c_inPlaceSize && alignof(F) <= alignof(std::max_align_t) && 
+				std::is_trivially_copyable<F>::value), int>::type = 0>
+			explicit MethodStorage(const F& method) : m_heap(new F(method)), m_delete(&DeleteStub<F>)
+			{}
+
+			~MethodStorage()
+			{
+				if(m_heap)
+				{
+					m_delete(m_heap);
+				}
+			}
+
+			MethodStorage(const MethodStorage&) = delete;
+			MethodStorage& operator=(const MethodStorage&) = delete;
+
+			const void* Get() const { return m_heap ? m_heap : m_inPlace; }
+		};
 
 		// VarMethod - Return Type
-		template<typename ReturnT, typename Object, bool isConst, typename... Args>
+		// One class per signature shape, ReturnT(Args...), shared by all methods with that shape whatever their class, 
+		// so they share a vtable and one copy of the unpacking and boxing code. The method itself is data: its F 
+		// (a member function pointer of any cv/ref/noexcept qualification, a function pointer, or a callable), 
+		// and the CallStub<F> that calls it.
+		// Arguments that don't match their parameter's type exactly are converted first, see MetaConvert.h.
+		template<typename ReturnT, typename... Args>
 		class VarMethod : public Method
 		{
-			typedef typename MethodPtr<ReturnT, Object, isConst, Args...>::MethodPointerT MethodPointerT;
-			MethodPointerT m_methodPtr;
+			typedef expr::signature_descriptors<expr::expression<ReturnT(*)(Args...)>, TypeDescriptor> Signature;
+			typedef ReturnT (*Stub)(const void* method, Any& obj, Args&&... args);
+
+			MethodStorage m_method;
+			Stub m_stub;
+			ConversionCache m_conversions;
+
+			// Unpacks argv to the parameter types; by-value and rvalue reference arguments are moved out of it.
+			template<unsigned int... Is>
+			ReturnT Call(Any& obj, Any* argv, indices<Is...>) const
+			{
+				return m_stub(m_method.Get(), obj, UnpackArg<Args>(argv[Is])...);
+			}
+
+		protected:
+			void ConvertArgs(Any* argv) const { m_conversions.Apply(argv, expr::detail::type_pack<Args...>()); }
+
+			// Calls with arguments already converted by ConvertArgs().
+			ReturnT CallConverted(Any& obj, Any* argv) const
+			{
+				return Call(obj, argv, build_indices<sizeof...(Args)>{});
+			}
+
+			ReturnT Call(Any& obj, Any* argv) const
+			{
+				assert((sizeof...(Args) >  0 && argv != nullptr) ||		// if has args, must not have null argv.
+						(sizeof...(Args) == 0 && argv == nullptr)    );	// if no args, must have null argv.
+				ConvertArgs(argv);
+				return CallConverted(obj, argv);
+			}
+
 		public:
-			VarMethod(const char* name, MethodPointerT method) :
-				Method(name),
-				m_methodPtr(method)
+			template<typename F>
+			VarMethod(const char* name, F method) :
+				Method(name, Signature::params, sizeof...(Args), Signature::ret),
+				m_method(method),
+				m_stub(&CallStub<F, ReturnT, Args...>)
 			{}
 
-			virtual int GetArity() const { return sizeof...(Args); }
-			virtual TypeRecord GetReturnType() const { return make_type_record<ReturnT>::type(); } 
-			virtual TypeRecord GetParamType(unsigned int i) const 
-			{ 
-				return make_type_record_byVariadicIndex<Args...>(i);
-			} 
-
 			virtual Any DoCall(Any& obj, Any* argv) const 
 			{
-				return make_any<ReturnT>::make(meta::internal::Call(m_methodPtr, obj.getPointer<Object>(), argv));
+				META_INSTRUMENT_CALL(this);
+				META_TRACE_CALL(this, argv);
+				return make_any<ReturnT>::make(Call(obj, argv));
+			}
+
+			virtual void DoCallInto(Any& obj, Any* argv, void* result) const
+			{
+				META_INSTRUMENT_CALL(this);
+				META_TRACE_CALL(this, argv);
+				new (result) typename std::decay<ReturnT>::type(Call(obj, argv));
+			}
+
+			virtual const anyimpl::base_any_policy* GetResultPolicy() const
+			{
+				return anyimpl::get_policy<typename std::decay<ReturnT>::type>();
 			}
 		};
 
 		
 		// VarMethod - void Return
-		template<typename Object, bool isConst, typename... Args>
-		class VarMethod<void, Object, isConst, Args...> : public Method
+		template<typename... Args>
+		class VarMethod<void, Args...> : public Method
 		{
-			typedef typename MethodPtr<void, Object, isConst, Args...>::MethodPointerT MethodPointerT;
-			MethodPointerT m_methodPtr;
+			typedef expr::signature_descriptors<expr::expression<void(*)(Args...)>, TypeDescriptor> Signature;
+			typedef void (*Stub)(const void* method, Any& obj, Args&&... args);
+
+			MethodStorage m_method;
+			Stub m_stub;
+			ConversionCache m_conversions;
+
+			template<unsigned int... Is>
+			void Call(Any& obj, Any* argv, indices<Is...>) const
+			{
+				m_stub(m_method.Get(), obj, UnpackArg<Args>(argv[Is])...);
+			}
+
+		protected:
+			void ConvertArgs(Any* argv) const { m_conversions.Apply(argv, expr::detail::type_pack<Args...>()); }
+
+			void Call(Any& obj, Any* argv) const
+			{
+				assert((sizeof...(Args) >  0 && argv != nullptr) ||
+						(sizeof...(Args) == 0 && argv == nullptr)    );
+				ConvertArgs(argv);
+				Call(obj, argv, build_indices<sizeof...(Args)>{});
+			}
+
 		public:
-			VarMethod(const char* name, MethodPointerT method) :
-				Method(name),
-				m_methodPtr(method)
+			template<typename F>
+			VarMethod(const char* name, F method) :
+				Method(name, Signature::params, sizeof...(Args), Signature::ret),
+				m_method(method),
+				m_stub(&CallStub<F, void, Args...>)
 			{}
 
-			virtual int GetArity() const { return sizeof...(Args); }
-			virtual TypeRecord GetReturnType() const { return make_type_record<void>::type(); } 
-			virtual TypeRecord GetParamType(unsigned int i) const 
-			{ 
-				return make_type_record_byVariadicIndex<Args...>(i);
-			} 
-
 			//void return
 			virtual Any DoCall(Any& obj, Any* argv) const 
 			{
-				meta::internal::Call(m_methodPtr, obj.getPointer<Object>(), argv);
+				META_INSTRUMENT_CALL(this);
+				META_TRACE_CALL(this, argv);
+				Call(obj, argv);
 				return Any();
 			}
+
+			virtual void DoCallInto(Any& obj, Any* argv, void*) const
+			{
+				DoCall(obj, argv);
+			}
+
+			virtual const anyimpl::base_any_policy* GetResultPolicy() const
+			{
+				return anyimpl::get_policy<anyimpl::empty_any>();
+			}
 		};
 
-		// Saves a function pointer inside a VarMethod
-		template<typename Object, typename ReturnType, typename... Args>
-		Method* createMethod(const char* name, ReturnType(Object::*method)(Args...))
+		// The VarMethod for F's shape.
+		template<typename F, typename Pack = typename method_traits<F>::ArgsPack>
+		struct var_method_for;
+
+		template<typename F, typename... Args>
+		struct var_method_for<F, expr::detail::type_pack<Args...>>
 		{
-			return new meta::internal::VarMethod<ReturnType, Object, false, Args...>(name, method);
+			typedef VarMethod<typename method_traits<F>::ReturnT, Args...> type;
+		};
+
+		/***************************************************************/
+		//                        MemoizedMethod                       //
+		/***************************************************************/
+
+		// Bumped by InvalidateMemoized(). Entries cached under an older generation miss.
+		extern std::atomic<uint64_t> g_memoGeneration;
+
+		inline uint64_t MixMemoKey(uint64_t hash, uint64_t value)
+		{
+			hash = (hash ^ value) * 0x9E3779B97F4A7C15ull;
+			return hash ^ (hash >> 29);
 		}
 
-		template<typename Object, typename ReturnType, typename... Args>
-		Method* createMethod(const char* name, ReturnType(Object::*method)(Args...) const)
+		// A const method whose result depends only on its receiver and arguments, registered with pure_method().
+		// Results are cached in a fixed number of slots, spread over shards that lock separately, and keyed on the
+		// receiver's address and GetVersion(), and the argument values (hashed with internal::value_hash, compared
+		// with operator==). A newer result evicts whatever shares its slot.
+		// Hits and misses are both instrumented and traced as calls of this method; only misses reach the method.
+		template<typename F, typename Pack = typename method_traits<F>::ArgsPack>
+		class MemoizedMethod;
+
+		template<typename F, typename... Args>
+		class MemoizedMethod<F, expr::detail::type_pack<Args...>> : public var_method_for<F>::type
 		{
-			return new meta::internal::VarMethod<ReturnType, Object, true, Args...>(name, method);
+			typedef typename var_method_for<F>::type Base;
+			typedef typename method_traits<F>::Object Object;
+			typedef typename method_traits<F>::ReturnT ReturnT;
+			typedef std::tuple<typename std::decay<Args>::type...> Key;
+
+			static_assert(std::conjunction<std::integral_constant<bool, value_hash<typename std::decay<Args>::type>::enabled &&
+				has_equal_operator<typename std::decay<Args>::type>::value>...>::value,
+				"TypeDataBuilder::pure_method(), arguments need a std::hash and an operator==.");
+
+			static const size_t c_shards = 16;
+
+			struct Entry
+			{
+				const void* m_receiver;
+				uint64_t m_version;
+				uint64_t m_generation;
+				std::optional<Key> m_args;	// empty while the slot is unused
+				Any m_result;
+			};
+
+			struct Shard
+			{
+				std::mutex m_mutex;
+				std::vector<Entry> m_entries;
+			};
+
+			std::unique_ptr<Shard[]> m_shards;
+			size_t m_slotMask;
+
+			template<unsigned int... Is>
+			Any Lookup(Any& obj, Any* argv, indices<Is...>) const
+			{
+				this->ConvertArgs(argv);
+				const Any* values = argv;	// read in place, so shared arguments stay shared
+
+				const Object* receiver = GetConstReceiver<Object>(obj);
+				uint64_t version = (uint64_t)receiver->GetVersion();
+				uint64_t generation = g_memoGeneration.load(std::memory_order_acquire);
+
+				uint64_t hash = MixMemoKey(reinterpret_cast<uintptr_t>(receiver), version);
+				(void)std::initializer_list<int>{ (hash = MixMemoKey(hash, value_hash<typename std::decay<Args>::type>::Hash(values[Is].template cast<typename std::decay<Args>::type>())), 0)... };
+
+				Shard& shard = m_shards[hash % c_shards];
+				Entry& entry = shard.m_entries[(hash / c_shards) & m_slotMask];
+				{
+					std::lock_guard<std::mutex> lock(shard.m_mutex);
+					if(entry.m_args && entry.m_receiver == receiver && entry.m_version == version && entry.m_generation == generation &&
+						*entry.m_args == std::forward_as_tuple(values[Is].template cast<typename std::decay<Args>::type>()...))
+					{
+						return entry.m_result;
+					}
+				}
+
+				// Copied before the call, which may move the arguments out of argv.
+				Key args(values[Is].template cast<typename std::decay<Args>::type>()...);
+				Any result = make_any<ReturnT>::make(this->CallConverted(obj, argv));
+
+				std::lock_guard<std::mutex> lock(shard.m_mutex);
+				entry.m_receiver = receiver;
+				entry.m_version = version;
+				entry.m_generation = generation;
+				entry.m_args.emplace(std::move(args));
+				entry.m_result = result;
+				return result;
+			}
+
+		public:
+			// capacity is the number of cached results: each shard gets capacity / shard count slots, rounded up to a
+			// power of two.
+			MemoizedMethod(const char* name, F method, size_t capacity) :
+				Base(name, method),
+				m_shards(new Shard[c_shards])
+			{
+				size_t slots = 1;
+				while(slots * c_shards < capacity)
+				{
+					slots *= 2;
+				}
+				m_slotMask = slots - 1;
+
+				for(size_t i = 0; i < c_shards; ++i)
+				{
+					m_shards[i].m_entries.resize(slots);
+				}
+			}
+
+			virtual Any DoCall(Any& obj, Any* argv) const
+			{
+				META_INSTRUMENT_CALL(this);
+				META_TRACE_CALL(this, argv);
+				return Lookup(obj, argv, build_indices<sizeof...(Args)>{});
+			}
+
+			// Cached results are copied out of their Any.
+			virtual void DoCallInto(Any& obj, Any* argv, void* result) const
+			{
+				META_INSTRUMENT_CALL(this);
+				META_TRACE_CALL(this, argv);
+				Any cached = Lookup(obj, argv, build_indices<sizeof...(Args)>{});
+				new (result) ReturnT(std::move(cached.template cast<ReturnT>()));
+			}
+		};
+
+		// Saves a function pointer or callable inside the VarMethod for its shape
+		template<typename F>
+		Method* createMethod(const char* name, F method)
+		{
+			return new typename var_method_for<F>::type(name, method);
 		}
 		
 		/**************************************************************/
 		//                      TypeDataBuilder                       //
 		/**************************************************************/
 
+		// Types are named by their fully qualified name, see internal::TypeName.
 		template <typename Object, bool IsClass>
 		struct TypeDataBuilder : public TypeData
 		{
-			TypeDataBuilder(const char* name, size_t size) : TypeData(name, size) {}
+			TypeDataBuilder() : TypeData(TypeName<Object>::c_str(), TypeName<Object>::hash, sizeof(Object), alignof(Object), MakeLifecycle<Object>()) {}
 
 			template<typename T> 
 			typename std::enable_if<!std::is_member_function_pointer<T>::value, TypeDataBuilder&>::type member(const char* name, T Object::*memberVar )
 			{
-				const TypeData* t_data = meta::Get<T>();
-				m_members.push_back(new ConcreteMember<Object, typename std::remove_reference<T>::type>(name, t_data, memberVar));
+				m_members.push_back(new ConcreteMember<Object, typename std::remove_reference<T>::type>(name, memberVar));
 				
 				return *this;
 			}
 
-			template<typename ReturnType, typename... Args>
-			TypeDataBuilder& method(const char* name, ReturnType(Object::*method)(Args...) )
+			// Methods of Object with any cv/ref/noexcept qualification, 
+			// or free functions and callables, which are called without an object.
+			template<typename F>
+			TypeDataBuilder& method(const char* name, F method)
 			{
+				typedef typename method_traits<F>::Object MethodObject;
+				static_assert(std::is_same<MethodObject, void>::value || std::is_same<MethodObject, Object>::value, 
+					"TypeDataBuilder::method(), method belongs to a different type.");
+
 				m_methods.push_back(createMethod(name, method));
 				return *this;
 			}
 
-			template<typename ReturnType, typename... Args>
-			TypeDataBuilder& method(const char* name, ReturnType(Object::*method)(Args...) const )
+			// Const methods whose result only depends on the object and the arguments. Their results are cached
+			// (see MemoizedMethod), so calling one again is a lookup.
+			// The object must have a GetVersion() that changes on every change, and that never repeats across objects:
+			// a new object can reuse a destroyed one's address (TypeData::Create() allocates from a pool), so take
+			// versions from meta::NextVersion() on construction and on each change.
+			// Argument types need a std::hash (or be pairs or containers of such types, see internal::value_hash) and
+			// an operator==.
+			template<typename F>
+			TypeDataBuilder& pure_method(const char* name, F method, size_t capacity = 256)
 			{
-				m_methods.push_back(createMethod(name, method));
+				typedef typename method_traits<F>::Object MethodObject;
+				typedef typename method_traits<F>::ReturnT ReturnT;
+				static_assert(std::is_same<MethodObject, Object>::value && method_traits<F>::isConst, 
+					"TypeDataBuilder::pure_method(), only const methods of this type can be memoized.");
+				static_assert(!std::is_void<ReturnT>::value && !std::is_reference<ReturnT>::value, 
+					"TypeDataBuilder::pure_method(), memoized methods return by value.");
+				static_assert(has_getVersion_function<Object>::value, 
+					"TypeDataBuilder::pure_method(), the object needs a GetVersion() to key cached results on.");
+
+				m_methods.push_back(new MemoizedMethod<F>(name, method, capacity));
 				return *this;
 			}
 
@@ -654,7 +1583,7 @@ namespace meta
 		template <typename Object> 
 		struct TypeDataBuilder<Object*, true> : public TypeData
 		{
-			TypeDataBuilder(const char* name, size_t size) : TypeData(name, size) 
+			TypeDataBuilder() : TypeData(TypeName<Object*>::c_str(), TypeName<Object*>::hash, sizeof(Object*), alignof(Object*), MakeLifecycle<Object*>()) 
 			{}
 		};
 
@@ -662,22 +1591,47 @@ namespace meta
 		template <typename Object> 
 		struct TypeDataBuilder<Object, false> : public TypeData
 		{
-			TypeDataBuilder(const char* name, size_t size) : TypeData(name, size) 
+			TypeDataBuilder() : TypeData(TypeName<Object>::c_str(), TypeName<Object>::hash, sizeof(Object), alignof(Object), MakeLifecycle<Object>()) 
 			{}
 		};
 	}
 
+	// Drops every result cached by pure methods. Call after changing an object without changing its GetVersion().
+	void InvalidateMemoized();
+
+	// A version no other call returns, for GetVersion() (see pure_method()).
+	uint64_t NextVersion();
+
+	// Calls method on object, which is passed by pointer (not copied).
+	// Arguments are forwarded, so rvalues are moved through to by-value and T&& parameters.
 	template<typename Object_T, typename... Args>
-	Any Invoke(const Method* method, Object_T& object, Args... args)
+	Any Invoke(const Method* method, Object_T& object, Args&&... args)
 	{
-		Any argV[sizeof...(Args)] = { Any(args)... };
-		return method->DoCall(Any(object), argV);
+		Any obj(&object);
+		Any argV[sizeof...(Args)] = { Any(std::forward<Args>(args))... };
+		return method->DoCall(obj, argV);
 	}
 
 	template<typename Object_T>
 	Any Invoke(const Method* method, Object_T& object)
 	{
-		return method->DoCall(Any(object), nullptr);
+		Any obj(&object);
+		return method->DoCall(obj, nullptr);
+	}
+
+	// Like Invoke(), but constructs the result in result, uninitialized storage for an R (see Method::DoCallInto()).
+	// Throws anyimpl::bad_any_cast, before calling, if R isn't the method's return type without its reference.
+	template<typename R, typename Object_T, typename... Args>
+	void InvokeInto(R* result, const Method* method, Object_T& object, Args&&... args)
+	{
+		if(method->GetResultPolicy() != anyimpl::get_policy<R>())
+		{
+			throw anyimpl::bad_any_cast();
+		}
+
+		Any obj(&object);
+		Any argV[sizeof...(Args) + 1] = { Any(std::forward<Args>(args))... };
+		method->DoCallInto(obj, sizeof...(Args) ? argV : nullptr, result);
 	}
 }
 
@@ -694,9 +1648,9 @@ namespace meta
 
 /// Declares and Defines meta information externally to a type.
 #define meta_declare_primitive(T)	\
-	template<> const meta::TypeData_Creator meta::internal::TypeDataHolder<T>::s_TypeData = meta::internal::TypeDataBuilder<T, !std::is_fundamental<T>::value>(#T, sizeof(T))
+	template<> const meta::TypeData_Creator meta::internal::TypeDataHolder<T>::s_TypeData = meta::internal::TypeDataBuilder<T, !std::is_fundamental<T>::value>()
 
 
 /// Defines meta information externally. Pair with meta_declare.
 #define meta_define(T) \
-	const meta::TypeData_Creator T::TypeDataStaticHolder::s_TypeData = meta::internal::TypeDataBuilder<T, !std::is_fundamental<T>::value>(#T, sizeof(T))
+	const meta::TypeData_Creator T::TypeDataStaticHolder::s_TypeData = meta::internal::TypeDataBuilder<T, !std::is_fundamental<T>::value>()
@@ -0,0 +1,234 @@
+#include "MetaArchetype.h"
+#include <new>
+
+namespace meta
+{
+	static size_t AlignUp(size_t offset, size_t alignment)
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	// For relocations made while unwinding from a throwing one: a second throw calls std::terminate() instead of
+	// leaving a row half moved.
+	static void RelocateOrTerminate(const TypeData* type, void* at, void* source) noexcept
+	{
+		type->RelocateArray(at, source, 1);
+	}
+
+	Archetype::Archetype(const std::vector<const TypeData*>& components, size_t chunkBytes) :
+		m_components(components),
+		m_chunkAlignment(alignof(std::max_align_t)),
+		m_size(0)
+	{
+		size_t rowBytes = 0;
+		for(unsigned int c = 0; c < m_components.size(); ++c)
+		{
+			for(const Member* member : m_components[c]->GetMembers())
+			{
+				m_columns.push_back(ColumnInfo{ c, member, member->GetStorageType(), member->GetSize(), 0 });
+				rowBytes += member->GetSize();
+				m_chunkAlignment = member->GetAlignment() > m_chunkAlignment ? member->GetAlignment() : m_chunkAlignment;
+			}
+		}
+
+		m_rowsPerChunk = rowBytes ? chunkBytes / rowBytes : chunkBytes;
+		m_rowsPerChunk = m_rowsPerChunk ? m_rowsPerChunk : 1;
+
+		size_t offset = 0;
+		size_t scratchOffset = 0;
+		for(ColumnInfo& column : m_columns)
+		{
+			column.m_offset = AlignUp(offset, column.m_member->GetAlignment());
+			offset = column.m_offset + column.m_size * m_rowsPerChunk;
+
+			m_scratchOffsets.push_back(AlignUp(scratchOffset, column.m_member->GetAlignment()));
+			scratchOffset = m_scratchOffsets.back() + column.m_size;
+		}
+		m_chunkBytes = offset ? offset : 1;
+		m_scratch = static_cast<unsigned char*>(::operator new(scratchOffset ? scratchOffset : 1, std::align_val_t(m_chunkAlignment)));
+	}
+
+	Archetype::~Archetype()
+	{
+		for(size_t chunk = 0; chunk < GetChunkCount(); ++chunk)
+		{
+			Chunk rows = GetChunk(chunk);
+			for(size_t column = 0; column < m_columns.size(); ++column)
+			{
+				m_columns[column].m_type->DestroyArray(rows.GetColumn(column), rows.GetRowCount());
+			}
+		}
+
+		for(unsigned char* chunk : m_chunks)
+		{
+			::operator delete(chunk, std::align_val_t(m_chunkAlignment));
+		}
+		::operator delete(m_scratch, std::align_val_t(m_chunkAlignment));
+	}
+
+	size_t Archetype::GetColumnIndex(const Member* member) const
+	{
+		for(size_t column = 0; column < m_columns.size(); ++column)
+		{
+			if(m_columns[column].m_member == member)
+			{
+				return column;
+			}
+		}
+		throw std::out_of_range("Archetype::GetColumnIndex(), member is not in this archetype");
+	}
+
+	Archetype::Chunk Archetype::GetChunk(size_t chunk) const
+	{
+		size_t first = chunk * m_rowsPerChunk;
+		size_t rows = m_size - first < m_rowsPerChunk ? m_size - first : m_rowsPerChunk;
+		return Chunk(this, m_chunks[chunk], rows);
+	}
+
+	void* Archetype::GetValue(size_t row, size_t column) const
+	{
+		const ColumnInfo& info = m_columns[column];
+		return m_chunks[row / m_rowsPerChunk] + info.m_offset + (row % m_rowsPerChunk) * info.m_size;
+	}
+
+	// Makes room for one more row (without counting it).
+	unsigned char* Archetype::Reserve()
+	{
+		if(m_size == m_chunks.size() * m_rowsPerChunk)
+		{
+			m_chunks.push_back(static_cast<unsigned char*>(::operator new(m_chunkBytes, std::align_val_t(m_chunkAlignment))));
+		}
+		return m_chunks[m_size / m_rowsPerChunk];
+	}
+
+	size_t Archetype::Add()
+	{
+		Reserve();
+
+		size_t column = 0;
+		try
+		{
+			for(; column < m_columns.size(); ++column)
+			{
+				m_columns[column].m_type->ConstructArray(GetValue(m_size, column), 1);
+			}
+		}
+		catch(...)
+		{
+			while(column-- > 0)
+			{
+				m_columns[column].m_type->DestroyArray(GetValue(m_size, column), 1);
+			}
+			throw;
+		}
+
+		return m_size++;
+	}
+
+	size_t Archetype::Add(const std::vector<const void*>& components)
+	{
+		assert(components.size() == m_components.size() && "Archetype::Add(), one object per component");
+		Reserve();
+
+		size_t column = 0;
+		try
+		{
+			for(; column < m_columns.size(); ++column)
+			{
+				const ColumnInfo& info = m_columns[column];
+				info.m_type->CopyArray(GetValue(m_size, column), info.m_member->GetPointer(components[info.m_component]), 1);
+			}
+		}
+		catch(...)
+		{
+			while(column-- > 0)
+			{
+				m_columns[column].m_type->DestroyArray(GetValue(m_size, column), 1);
+			}
+			throw;
+		}
+
+		return m_size++;
+	}
+
+	void Archetype::Remove(size_t row)
+	{
+		if(row >= m_size)
+		{
+			throw std::out_of_range("Archetype::Remove(), row out of range");
+		}
+
+		size_t last = m_size - 1;
+		if(row != last)
+		{
+			for(const ColumnInfo& info : m_columns)
+			{
+				if(!(info.m_type->GetFlags() & TypeLifecycle::F_TriviallyCopyable) && !info.m_type->GetLifecycle().m_relocateArray)
+				{
+					throw std::logic_error("Archetype::Remove(), member type is not move constructible");
+				}
+			}
+
+			// Column by column, the removed value moves aside into m_scratch and the last row's into its place.
+			// Nothing is destroyed until every column has moved.
+			size_t column = 0;
+			bool aside = false;		// column's removed value is in m_scratch, and its slot is empty
+			try
+			{
+				for(; column < m_columns.size(); ++column)
+				{
+					const TypeData* type = m_columns[column].m_type;
+					type->RelocateArray(m_scratch + m_scratchOffsets[column], GetValue(row, column), 1);
+					aside = true;
+					type->RelocateArray(GetValue(row, column), GetValue(last, column), 1);
+					aside = false;
+				}
+			}
+			catch(...)
+			{
+				if(aside)
+				{
+					RelocateOrTerminate(m_columns[column].m_type, GetValue(row, column), m_scratch + m_scratchOffsets[column]);
+				}
+				while(column-- > 0)
+				{
+					const TypeData* type = m_columns[column].m_type;
+					RelocateOrTerminate(type, GetValue(last, column), GetValue(row, column));
+					RelocateOrTerminate(type, GetValue(row, column), m_scratch + m_scratchOffsets[column]);
+				}
+				throw;
+			}
+		}
+
+		for(size_t column = 0; column < m_columns.size(); ++column)
+		{
+			m_columns[column].m_type->DestroyArray(row != last ? m_scratch + m_scratchOffsets[column] : GetValue(row, column), 1);
+		}
+		--m_size;
+	}
+
+	// Members of a live object, and the stored values, are copy assigned: a throwing copy leaves them alive.
+	void Archetype::Load(size_t row, unsigned int component, void* object) const
+	{
+		for(size_t column = 0; column < m_columns.size(); ++column)
+		{
+			const ColumnInfo& info = m_columns[column];
+			if(info.m_component == component)
+			{
+				info.m_type->AssignArray(info.m_member->GetPointer(object), GetValue(row, column), 1);
+			}
+		}
+	}
+
+	void Archetype::Store(size_t row, unsigned int component, const void* object)
+	{
+		for(size_t column = 0; column < m_columns.size(); ++column)
+		{
+			const ColumnInfo& info = m_columns[column];
+			if(info.m_component == component)
+			{
+				info.m_type->AssignArray(GetValue(row, column), info.m_member->GetPointer(object), 1);
+			}
+		}
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+// Struct-of-arrays storage for a set of reflected component types.
+// Every reflected member of every component gets its own column, and rows live in fixed-size chunks,
+// so a pass over one member streams through contiguous memory.
+// Only reflected members are stored. Column values are handled through the member types' TypeLifecycle.
+
+#include "Meta.h"
+#include <vector>
+
+namespace meta
+{
+	class Archetype
+	{
+	public:
+		struct ColumnInfo
+		{
+			unsigned int m_component;	// index into GetComponents()
+			const Member* m_member;
+			const TypeData* m_type;
+			size_t m_size;
+			size_t m_offset;			// of the column within a chunk
+		};
+
+		// A chunk's rows. Column c holds GetRowCount() values of GetColumns()[c].m_type.
+		class Chunk
+		{
+			friend class Archetype;
+
+			const Archetype* m_archetype;
+			unsigned char* m_data;
+			size_t m_rows;
+
+			Chunk(const Archetype* archetype, unsigned char* data, size_t rows) : m_archetype(archetype), m_data(data), m_rows(rows) {}
+
+		public:
+			size_t GetRowCount() const { return m_rows; }
+
+			void* GetColumn(size_t column) const { return m_data + m_archetype->m_columns[column].m_offset; }
+
+			template <typename T>
+			T* GetColumn(const Member* member) const
+			{
+				size_t column = m_archetype->GetColumnIndex(member);
+				assert(m_archetype->m_columns[column].m_size == sizeof(T) && "Archetype::Chunk::GetColumn, member is not a T");
+				return static_cast<T*>(GetColumn(column));
+			}
+		};
+
+		static const size_t c_defaultChunkBytes = 16 * 1024;
+
+		explicit Archetype(const std::vector<const TypeData*>& components, size_t chunkBytes = c_defaultChunkBytes);
+		~Archetype();
+
+		Archetype(const Archetype&) = delete;
+		Archetype& operator=(const Archetype&) = delete;
+
+		const std::vector<const TypeData*>& GetComponents() const { return m_components; }
+		const std::vector<ColumnInfo>& GetColumns() const { return m_columns; }
+
+		// Throws std::out_of_range if the member isn't one of the components'.
+		size_t GetColumnIndex(const Member* member) const;
+
+		size_t Size() const { return m_size; }
+		size_t GetRowsPerChunk() const { return m_rowsPerChunk; }
+		size_t GetChunkCount() const { return (m_size + m_rowsPerChunk - 1) / m_rowsPerChunk; }
+		Chunk GetChunk(size_t chunk) const;
+
+		// Appends a row of default constructed values, and returns its index.
+		size_t Add();
+
+		// Appends a row copied from one object per component, in GetComponents() order.
+		size_t Add(const std::vector<const void*>& components);
+
+		// Removes a row by moving the last row into its place. Throws std::logic_error, leaving the rows as they were,
+		// if a column type can't be relocated. If a relocation throws, the columns already moved are put back before
+		// it's rethrown (a second throw doing so calls std::terminate()).
+		void Remove(size_t row);
+
+		// Copies a row's members of one component into an existing object.
+		void Load(size_t row, unsigned int component, void* object) const;
+		void Store(size_t row, unsigned int component, const void* object);
+
+		void* GetValue(size_t row, size_t column) const;
+
+	private:
+		unsigned char* Reserve();
+
+		std::vector<const TypeData*> m_components;
+		std::vector<ColumnInfo> m_columns;
+		std::vector<unsigned char*> m_chunks;
+		unsigned char* m_scratch;				// one row, where Remove() moves the removed row's values aside
+		std::vector<size_t> m_scratchOffsets;	// of each column's value in m_scratch
+		size_t m_rowsPerChunk;
+		size_t m_chunkBytes;
+		size_t m_chunkAlignment;
+		size_t m_size;
+	};
+}
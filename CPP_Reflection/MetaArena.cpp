@@ -0,0 +1,85 @@
+#include "MetaArena.h"
+#include <new>
+
+namespace meta
+{
+	Arena::Arena(size_t blockBytes) : 
+		m_blockBytes(blockBytes), 
+		m_cursor(nullptr), 
+		m_end(nullptr), 
+		m_bytesUsed(0)
+	{}
+
+	Arena::~Arena()
+	{
+		DestroyCreated();
+		for(Block& block : m_blocks)
+		{
+			::operator delete(block.m_data, std::align_val_t(alignof(std::max_align_t)));
+		}
+	}
+
+	void Arena::AddBlock(size_t minimumBytes)
+	{
+		size_t size = minimumBytes > m_blockBytes ? minimumBytes : m_blockBytes;
+		Block block = { static_cast<unsigned char*>(::operator new(size, std::align_val_t(alignof(std::max_align_t)))), size };
+		m_blocks.push_back(block);
+
+		m_cursor = block.m_data;
+		m_end = block.m_data + size;
+	}
+
+	void* Arena::Allocate(size_t size, size_t alignment)
+	{
+		uintptr_t cursor = reinterpret_cast<uintptr_t>(m_cursor);
+		uintptr_t aligned = (cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+		if(!m_cursor || aligned + size > reinterpret_cast<uintptr_t>(m_end))
+		{
+			AddBlock(size + alignment);
+			cursor = reinterpret_cast<uintptr_t>(m_cursor);
+			aligned = (cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		}
+
+		m_cursor = reinterpret_cast<unsigned char*>(aligned + size);
+		m_bytesUsed += size;
+		return reinterpret_cast<void*>(aligned);
+	}
+
+	void* Arena::CreateCopy(const TypeData* type, const void* source)
+	{
+		void* instance = Allocate(type->GetSize(), type->GetAlignment());
+		type->CopyArray(instance, source, 1);
+
+		if(!(type->GetFlags() & TypeLifecycle::F_TriviallyDestructible))
+		{
+			m_created.push_back(Created{ type, instance });
+		}
+		return instance;
+	}
+
+	void Arena::DestroyCreated()
+	{
+		for(size_t i = m_created.size(); i-- > 0; )
+		{
+			m_created[i].m_type->DestroyArray(m_created[i].m_instance, 1);
+		}
+		m_created.clear();
+	}
+
+	void Arena::Reset()
+	{
+		DestroyCreated();
+		for(size_t i = 1; i < m_blocks.size(); ++i)
+		{
+			::operator delete(m_blocks[i].m_data, std::align_val_t(alignof(std::max_align_t)));
+		}
+		if(!m_blocks.empty())
+		{
+			m_blocks.resize(1);
+			m_cursor = m_blocks[0].m_data;
+			m_end = m_blocks[0].m_data + m_blocks[0].m_size;
+		}
+		m_bytesUsed = 0;
+	}
+}
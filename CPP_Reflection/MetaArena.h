@@ -0,0 +1,56 @@
+#pragma once
+
+// Bump allocator for reflected objects that live and die together.
+// Objects constructed through Arena::Create*() are destroyed, newest first, when the arena is reset or destroyed.
+
+#include "Meta.h"
+#include <vector>
+
+namespace meta
+{
+	class Arena
+	{
+	public:
+		static const size_t c_defaultBlockBytes = 64 * 1024;
+
+		explicit Arena(size_t blockBytes = c_defaultBlockBytes);
+		~Arena();
+
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+
+		// Uninitialized memory, valid until Reset().
+		void* Allocate(size_t size, size_t alignment);
+
+		// Copy constructs an instance of type in the arena.
+		void* CreateCopy(const TypeData* type, const void* source);
+
+		// Destroys every object created here and releases all but the first block.
+		void Reset();
+
+		size_t GetBytesUsed() const { return m_bytesUsed; }
+
+	private:
+		struct Block
+		{
+			unsigned char* m_data;
+			size_t m_size;
+		};
+
+		struct Created
+		{
+			const TypeData* m_type;
+			void* m_instance;
+		};
+
+		void AddBlock(size_t minimumBytes);
+		void DestroyCreated();
+
+		size_t m_blockBytes;
+		std::vector<Block> m_blocks;
+		unsigned char* m_cursor;
+		unsigned char* m_end;
+		size_t m_bytesUsed;
+		std::vector<Created> m_created;	// only those with a destructor to run
+	};
+}
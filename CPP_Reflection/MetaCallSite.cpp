@@ -0,0 +1,45 @@
+#include "MetaCallSite.h"
+#include <stdexcept>
+
+namespace meta
+{
+	const Method* CallSite::ResolveMiss(const TypeData* type)
+	{
+		if(!m_megamorphic.empty())
+		{
+			std::unordered_map<const TypeData*, const Method*>::const_iterator found = m_megamorphic.find(type);
+			if(found != m_megamorphic.end())
+			{
+				return found->second;
+			}
+		}
+
+		const Method* method = type->GetMethod(m_name);
+		if(m_count < c_ways)
+		{
+			m_entries[m_count++] = Entry{ type, method };
+			return method;
+		}
+
+		// One type too many for the inline entries: they move into the map, which takes every type from now on.
+		if(m_megamorphic.empty())
+		{
+			for(const Entry& entry : m_entries)
+			{
+				m_megamorphic.emplace(entry.m_type, entry.m_method);
+			}
+		}
+		m_megamorphic.emplace(type, method);
+		return method;
+	}
+
+	const Method* CallSite::Require(const TypeData* type)
+	{
+		const Method* method = Resolve(type);
+		if(!method)
+		{
+			throw std::out_of_range("CallSite::Call(), " + std::string(type->GetName()) + " has no method " + m_name);
+		}
+		return method;
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// By-name method calls that remember what the name resolved to.
+// A CallSite is made once per place that calls a method by name (a script call expression, say). It caches the
+// Method found for each receiver type it has seen: up to c_ways types in an inline array searched by pointer
+// compare, after which the site goes megamorphic and keeps a hash map. Only a type it hasn't seen looks the name up.
+// A CallSite is not thread safe; give each thread its own.
+
+#include "Meta.h"
+#include <string>
+#include <unordered_map>
+
+namespace meta
+{
+	class CallSite
+	{
+	public:
+		static const unsigned int c_ways = 4;
+
+		enum State
+		{
+			Uninitialized,
+			Monomorphic,
+			Polymorphic,
+			Megamorphic
+		};
+
+		explicit CallSite(std::string methodName) : m_name(std::move(methodName)), m_count(0) {}
+
+		// The method called on a type's objects, or null if it has none by this name.
+		const Method* Resolve(const TypeData* type)
+		{
+			for(unsigned int i = 0; i < m_count; ++i)
+			{
+				if(m_entries[i].m_type == type)
+				{
+					return m_entries[i].m_method;
+				}
+			}
+			return ResolveMiss(type);
+		}
+
+		// Calls the method on object, found by object's dynamic type. Throws std::out_of_range if it has none.
+		template<typename Object_T, typename... Args>
+		Any Call(Object_T& object, Args&&... args)
+		{
+			return Invoke(Require(Get(object)), object, std::forward<Args>(args)...);
+		}
+
+		// For callers that already hold the receiver and arguments boxed. Consumes argv like Method::DoCall().
+		Any Call(const TypeData* type, Any& object, Any* argv)
+		{
+			return Require(type)->DoCall(object, argv);
+		}
+
+		const std::string& GetName() const { return m_name; }
+
+		State GetState() const 
+		{ 
+			return !m_megamorphic.empty() ? Megamorphic : m_count > 1 ? Polymorphic : m_count == 1 ? Monomorphic : Uninitialized; 
+		}
+
+	private:
+		struct Entry
+		{
+			const TypeData* m_type;
+			const Method* m_method;
+		};
+
+		const Method* ResolveMiss(const TypeData* type);
+		const Method* Require(const TypeData* type);
+
+		std::string m_name;
+		Entry m_entries[c_ways];
+		unsigned int m_count;
+		std::unordered_map<const TypeData*, const Method*> m_megamorphic;
+	};
+}
@@ -0,0 +1,97 @@
+#include "MetaClone.h"
+#include <unordered_map>
+
+namespace meta
+{
+	namespace
+	{
+		struct CloneState
+		{
+			Arena& m_arena;
+			std::unordered_map<const void*, void*> m_remap;
+
+			struct Pending
+			{
+				const TypeData* m_type;
+				void* m_copy;
+			};
+			std::vector<Pending> m_pending;
+
+			explicit CloneState(Arena& arena) : m_arena(arena) {}
+
+			// A pointer to a base of a meta_declare type is cloned as its whole object, and points at the same base
+			// of the copy.
+			void* Clone(const TypeData* type, const void* original)
+			{
+				const void* object = original;
+				if(type->GetLifecycle().m_dynamicType)
+				{
+					object = type->GetLifecycle().m_mostDerived(original);
+				}
+				ptrdiff_t baseOffset = static_cast<const unsigned char*>(original) - static_cast<const unsigned char*>(object);
+
+				std::unordered_map<const void*, void*>::iterator found = m_remap.find(object);
+				if(found != m_remap.end())
+				{
+					return static_cast<unsigned char*>(found->second) + baseOffset;
+				}
+
+				if(type->GetLifecycle().m_dynamicType)
+				{
+					type = type->GetLifecycle().m_dynamicType(original);
+				}
+
+				void* copy = m_arena.CreateCopy(type, object);
+				m_remap.emplace(object, copy);
+				m_pending.push_back(Pending{ type, copy });
+				return static_cast<unsigned char*>(copy) + baseOffset;
+			}
+
+			// char pointers are C strings, and void pointers have nothing to copy: neither is one object of its type.
+			static bool IsFollowed(const TypeData* pointee)
+			{
+				return pointee->GetSize() != 0 && pointee != Get<char>();
+			}
+
+			// Redirects the pointer members of an object (or of a value member inside it) at offset in copy.
+			void FixPointers(const TypeData* type, unsigned char* copy)
+			{
+				for(const Member* member : type->GetMembers())
+				{
+					unsigned char* field = copy + member->GetOffset();
+					if(member->IsPointer())
+					{
+						void*& pointer = *reinterpret_cast<void**>(field);
+						if(pointer && IsFollowed(member->GetType()))
+						{
+							pointer = Clone(member->GetType(), pointer);
+						}
+					}
+					else if(!member->GetType()->GetMembers().empty())
+					{
+						FixPointers(member->GetType(), field);
+					}
+				}
+			}
+		};
+	}
+
+	void* DeepClone(const TypeData* type, const void* root, Arena& arena)
+	{
+		if(!root)
+		{
+			return nullptr;
+		}
+
+		CloneState state(arena);
+		void* copy = state.Clone(type, root);
+
+		// Breadth first: copies are allocated in the order they're discovered.
+		for(size_t i = 0; i < state.m_pending.size(); ++i)
+		{
+			CloneState::Pending pending = state.m_pending[i];
+			state.FixPointers(pending.m_type, static_cast<unsigned char*>(pending.m_copy));
+		}
+		return copy;
+	}
+}
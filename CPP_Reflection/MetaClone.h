@@ -0,0 +1,22 @@
+#pragma once
+
+// Deep copies of reflected object graphs into an Arena.
+// Objects are copy constructed, then their reflected pointer members are redirected to copies of their targets.
+// A pointer is taken to point at one object of its pointee type (not an array), and pointers to meta_declare types
+// at a whole object of their dynamic type, possibly through a base. An object reached twice is copied once, so
+// sharing and cycles survive. Copies are laid out breadth first, contiguously in the arena.
+// Pointers to char (C strings), void pointers, and unreflected pointers keep pointing at the originals.
+
+#include "MetaArena.h"
+
+namespace meta
+{
+	// Returns the copy of root, which lives until the arena is reset.
+	void* DeepClone(const TypeData* type, const void* root, Arena& arena);
+
+	template <typename T>
+	T* DeepClone(const T* root, Arena& arena)
+	{
+		return static_cast<T*>(DeepClone(Get<T>(), root, arena));
+	}
+}
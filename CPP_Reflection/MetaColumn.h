@@ -0,0 +1,162 @@
+#pragma once
+
+// Strided views of one reflected member across an array of objects, e.g. every A1::b in a std::vector<A1>.
+// Gather() packs the column into a contiguous buffer for vectorized passes, Scatter() writes one back.
+// 4 and 8 byte trivially copyable members gather with AVX2 when it's enabled (-mavx2, /arch:AVX2).
+
+#include "Meta.h"
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#endif
+
+namespace meta
+{
+	namespace internal
+	{
+		// Strided copies of trivially copyable elements.
+		template <size_t Size>
+		void GatherStrided(void* out, const unsigned char* base, size_t stride, size_t count)
+		{
+			unsigned char* dest = static_cast<unsigned char*>(out);
+			for(size_t i = 0; i < count; ++i)
+			{
+				std::memcpy(dest + i * Size, base + i * stride, Size);
+			}
+		}
+
+		template <size_t Size>
+		void ScatterStrided(unsigned char* base, const void* in, size_t stride, size_t count)
+		{
+			const unsigned char* source = static_cast<const unsigned char*>(in);
+			for(size_t i = 0; i < count; ++i)
+			{
+				std::memcpy(base + i * stride, source + i * Size, Size);
+			}
+		}
+
+	#if defined(__AVX2__)
+		// Gather offsets are 32 bit, larger strides take the scalar loop.
+		template <>
+		inline void GatherStrided<4>(void* out, const unsigned char* base, size_t stride, size_t count)
+		{
+			size_t i = 0;
+			if(stride <= 0x0FFFFFFF)
+			{
+				int s = (int)stride;
+				const __m256i offsets = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+				for(; i + 8 <= count; i += 8)
+				{
+					__m256i lanes = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base + i * stride), offsets, 1);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(static_cast<unsigned char*>(out) + i * 4), lanes);
+				}
+			}
+			for(; i < count; ++i)
+			{
+				std::memcpy(static_cast<unsigned char*>(out) + i * 4, base + i * stride, 4);
+			}
+		}
+
+		template <>
+		inline void GatherStrided<8>(void* out, const unsigned char* base, size_t stride, size_t count)
+		{
+			size_t i = 0;
+			if(stride <= 0x1FFFFFFF)
+			{
+				int s = (int)stride;
+				const __m128i offsets = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+				for(; i + 4 <= count; i += 4)
+				{
+					__m256i lanes = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(base + i * stride), offsets, 1);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(static_cast<unsigned char*>(out) + i * 8), lanes);
+				}
+			}
+			for(; i < count; ++i)
+			{
+				std::memcpy(static_cast<unsigned char*>(out) + i * 8, base + i * stride, 8);
+			}
+		}
+	#endif
+	}
+
+	template <typename T>
+	class Column
+	{
+		unsigned char* m_base;	// the member in the first object
+		size_t m_stride;
+		size_t m_count;
+
+		static void CheckMember(const Member* member)
+		{
+			if(!member || member->GetStorageType() != Get<T>() || member->GetSize() != sizeof(T))
+			{
+				throw std::invalid_argument("meta::Column, member is not a T");
+			}
+		}
+
+	public:
+		Column(void* objects, size_t stride, size_t count, const Member* member) :
+			m_base(static_cast<unsigned char*>(objects) + (member ? member->GetOffset() : 0)),
+			m_stride(stride),
+			m_count(count)
+		{
+			CheckMember(member);
+		}
+
+		template <typename Object>
+		Column(Object* objects, size_t count, const Member* member) : Column(static_cast<void*>(objects), sizeof(Object), count, member) 
+		{
+			assert(member->GetOwner() == Get<Object>() && "meta::Column, member belongs to another type");
+		}
+
+		template <typename Object>
+		Column(std::vector<Object>& objects, const Member* member) : Column(objects.data(), objects.size(), member) {}
+
+		size_t size() const { return m_count; }
+		size_t stride() const { return m_stride; }
+
+		T& operator[](size_t i) const { return *reinterpret_cast<T*>(m_base + i * m_stride); }
+
+		// Copies the column into out[0, size()).
+		void Gather(T* out) const
+		{
+			GatherImpl(out, std::is_trivially_copyable<T>());
+		}
+
+		std::vector<T> Gather() const
+		{
+			std::vector<T> values(m_count);
+			Gather(values.data());
+			return values;
+		}
+
+		// Writes in[0, size()) back into the column.
+		void Scatter(const T* in) const
+		{
+			ScatterImpl(in, std::is_trivially_copyable<T>());
+		}
+
+	private:
+		void GatherImpl(T* out, std::true_type) const { internal::GatherStrided<sizeof(T)>(out, m_base, m_stride, m_count); }
+		void ScatterImpl(const T* in, std::true_type) const { internal::ScatterStrided<sizeof(T)>(m_base, in, m_stride, m_count); }
+
+		void GatherImpl(T* out, std::false_type) const
+		{
+			for(size_t i = 0; i < m_count; ++i)
+			{
+				out[i] = (*this)[i];
+			}
+		}
+
+		void ScatterImpl(const T* in, std::false_type) const
+		{
+			for(size_t i = 0; i < m_count; ++i)
+			{
+				(*this)[i] = in[i];
+			}
+		}
+	};
+}
@@ -0,0 +1,167 @@
+#include "MetaConvert.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace meta
+{
+	namespace
+	{
+		struct PolicyPairHash
+		{
+			size_t operator()(const std::pair<const anyimpl::base_any_policy*, const anyimpl::base_any_policy*>& key) const
+			{
+				return std::hash<const void*>()(key.first) * 31 + std::hash<const void*>()(key.second);
+			}
+		};
+
+		typedef std::unordered_map<std::pair<const anyimpl::base_any_policy*, const anyimpl::base_any_policy*>, 
+			std::unique_ptr<Conversion>, PolicyPairHash> ConversionMap;
+
+		// static_cast, but a floating point value out of the destination's range throws instead: converting it is
+		// undefined. Values are truncated first, so -0.5 converts to an unsigned and 2^31 - 0.5 to an int.
+		template <typename To, typename From>
+		To ArithmeticCast(From from)
+		{
+			if constexpr(std::is_floating_point<From>::value && std::is_integral<To>::value && !std::is_same<To, bool>::value)
+			{
+				From truncated = std::trunc(from);
+				From limit = std::ldexp(From(1), std::numeric_limits<To>::digits);
+				if(!(truncated < limit && truncated >= (std::is_signed<To>::value ? -limit : From(0))))
+				{
+					throw anyimpl::bad_any_cast();
+				}
+			}
+			else if constexpr(std::is_floating_point<From>::value && std::is_floating_point<To>::value && sizeof(To) < sizeof(From))
+			{
+				if(std::isfinite(from) && std::fabs(from) > std::numeric_limits<To>::max())
+				{
+					throw anyimpl::bad_any_cast();
+				}
+			}
+			return static_cast<To>(from);
+		}
+
+		template <typename From, typename... To>
+		void AddArithmetic(ConversionMap& map)
+		{
+			(void)std::initializer_list<int>{ (std::is_same<From, To>::value ? 0 : 
+				(map[std::make_pair(anyimpl::get_policy<From>(), anyimpl::get_policy<To>())].reset(new Conversion{ 
+					anyimpl::get_policy<From>(), anyimpl::get_policy<To>(), 
+					[](const void* from) { return Any(ArithmeticCast<To>(*static_cast<const From*>(from))); } }), 0))... };
+		}
+
+		template <typename... Types>
+		void AddArithmeticMatrix(ConversionMap& map)
+		{
+			(void)std::initializer_list<int>{ (AddArithmetic<Types, Types...>(map), 0)... };
+		}
+
+		struct Registry
+		{
+			std::mutex m_mutex;
+			ConversionMap m_conversions;
+
+			Registry()
+			{
+				AddArithmeticMatrix<bool, char, signed char, unsigned char, short, unsigned short, int, unsigned int, 
+					long, unsigned long, long long, unsigned long long, float, double>(m_conversions);
+			}
+		};
+
+		Registry& GetRegistry()
+		{
+			static Registry s_registry;
+			return s_registry;
+		}
+	}
+
+	void internal::AddConversion(const anyimpl::base_any_policy* from, const anyimpl::base_any_policy* to, std::function<Any(const void*)> convert)
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.m_mutex);
+
+		// Plans may hold the old entry, so it's updated rather than replaced.
+		std::unique_ptr<Conversion>& entry = registry.m_conversions[std::make_pair(from, to)];
+		if(entry)
+		{
+			entry->m_convert = std::move(convert);
+		}
+		else
+		{
+			entry.reset(new Conversion{ from, to, std::move(convert) });
+		}
+	}
+
+	const Conversion* FindConversion(const anyimpl::base_any_policy* from, const anyimpl::base_any_policy* to)
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock(registry.m_mutex);
+
+		ConversionMap::const_iterator found = registry.m_conversions.find(std::make_pair(from, to));
+		return found == registry.m_conversions.end() ? nullptr : found->second.get();
+	}
+
+	namespace internal
+	{
+		const ConversionPlan* ConversionCache::FindPlan(Any* argv, const anyimpl::base_any_policy* const* expected, unsigned int arity) const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			for(const std::unique_ptr<ConversionPlan>& plan : m_plans)
+			{
+				if(std::equal(plan->m_from.begin(), plan->m_from.end(), argv, [](const anyimpl::base_any_policy* from, const Any& arg) { return from == arg.getPolicy(); }))
+				{
+					return plan.get();
+				}
+			}
+
+			std::unique_ptr<ConversionPlan> plan(new ConversionPlan());
+			for(unsigned int i = 0; i < arity; ++i)
+			{
+				const anyimpl::base_any_policy* from = argv[i].getPolicy();
+				const Conversion* conversion = nullptr;
+				if(from != expected[i])
+				{
+					conversion = FindConversion(from, expected[i]);
+					if(!conversion)
+					{
+						throw anyimpl::bad_any_cast();
+					}
+				}
+				plan->m_from.push_back(from);
+				plan->m_conversions.push_back(conversion);
+			}
+
+			m_plans.push_back(std::move(plan));
+			return m_plans.back().get();
+		}
+
+		void ConversionCache::Convert(Any* argv, const anyimpl::base_any_policy* const* expected, unsigned int arity) const
+		{
+			const ConversionPlan* plan = m_last.load(std::memory_order_acquire);
+			for(unsigned int i = 0; plan && i < arity; ++i)
+			{
+				if(plan->m_from[i] != argv[i].getPolicy())
+				{
+					plan = nullptr;
+				}
+			}
+
+			if(!plan)
+			{
+				plan = FindPlan(argv, expected, arity);
+				m_last.store(plan, std::memory_order_release);
+			}
+
+			for(unsigned int i = 0; i < arity; ++i)
+			{
+				if(const Conversion* conversion = plan->m_conversions[i])
+				{
+					argv[i] = conversion->m_convert(static_cast<const Any&>(argv[i]).getRawPointer());
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+// Conversions between the values anys hold, for calls whose arguments don't exactly match the parameters.
+// Conversions are registered per (source type, destination type) and found by the anys' policies, so they
+// work for any C++ type, registered with meta or not. Every pair of built-in arithmetic types converts with
+// static_cast (widening and narrowing alike), except that a floating point value out of the destination type's range
+// throws anyimpl::bad_any_cast; others are added with RegisterConversion().
+// Methods look conversions up only when an argument's type differs from its parameter's, and remember the plan
+// for the last argument types they were called with, so the exact-match path is a pointer compare per argument.
+
+#include "Any.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace meta
+{
+	struct Conversion
+	{
+		const anyimpl::base_any_policy* m_from;
+		const anyimpl::base_any_policy* m_to;
+		std::function<Any(const void* from)> m_convert;
+	};
+
+	namespace internal
+	{
+		void AddConversion(const anyimpl::base_any_policy* from, const anyimpl::base_any_policy* to, std::function<Any(const void*)> convert);
+	}
+
+	// Null if there's no conversion between the two. An exact match is not a conversion.
+	const Conversion* FindConversion(const anyimpl::base_any_policy* from, const anyimpl::base_any_policy* to);
+
+	// Registers convert (a callable taking const From&) for From -> To, replacing any earlier one.
+	// Meant for startup: replacing a conversion while another thread uses it is a race.
+	template <typename From, typename To, typename F>
+	void RegisterConversion(F convert)
+	{
+		internal::AddConversion(anyimpl::get_policy<From>(), anyimpl::get_policy<To>(), [convert](const void* from) -> Any
+		{
+			return Any(To(convert(*static_cast<const From*>(from))));
+		});
+	}
+
+	// Registers From -> To through static_cast.
+	template <typename From, typename To>
+	void RegisterConversion()
+	{
+		RegisterConversion<From, To>([](const From& from) { return static_cast<To>(from); });
+	}
+
+	// value as a To. Throws anyimpl::bad_any_cast if it isn't one and can't be converted to one.
+	template <typename To>
+	To ConvertTo(const Any& value)
+	{
+		if(value.is<To>())
+		{
+			return value.cast<To>();
+		}
+
+		const Conversion* conversion = FindConversion(value.getPolicy(), anyimpl::get_policy<To>());
+		if(!conversion)
+		{
+			throw anyimpl::bad_any_cast();
+		}
+		return conversion->m_convert(value.getRawPointer()).template cast<To>();
+	}
+
+	namespace internal
+	{
+		// The conversions for one list of argument types: a Conversion per argument, null where it already matches.
+		struct ConversionPlan
+		{
+			std::vector<const anyimpl::base_any_policy*> m_from;
+			std::vector<const Conversion*> m_conversions;
+		};
+
+		// A method's plans, one per list of mismatched argument types it has been called with.
+		class ConversionCache
+		{
+			mutable std::atomic<const ConversionPlan*> m_last;
+			mutable std::mutex m_mutex;
+			mutable std::vector<std::unique_ptr<ConversionPlan>> m_plans;
+
+			const ConversionPlan* FindPlan(Any* argv, const anyimpl::base_any_policy* const* expected, unsigned int arity) const;
+
+		public:
+			ConversionCache() : m_last(nullptr) {}
+
+			// Converts the arguments of argv that don't match expected in place: each is overwritten with its
+			// converted value, so the caller's anys change type. Throws anyimpl::bad_any_cast if one can't be converted,
+			// leaving the arguments before it converted.
+			void Convert(Any* argv, const anyimpl::base_any_policy* const* expected, unsigned int arity) const;
+
+			// Pack is a type list of the parameters, e.g. expr::detail::type_pack<Args...>.
+			template <template <typename...> class Pack, typename... Args>
+			void Apply(Any* argv, Pack<Args...>) const
+			{
+				if constexpr(sizeof...(Args) > 0)
+				{
+					const anyimpl::base_any_policy* const expected[] = { anyimpl::get_policy<typename std::decay<Args>::type>()... };
+					for(unsigned int i = 0; i < sizeof...(Args); ++i)
+					{
+						if(argv[i].getPolicy() != expected[i])
+						{
+							Convert(argv, expected, sizeof...(Args));
+							return;
+						}
+					}
+				}
+			}
+		};
+	}
+}
@@ -0,0 +1,394 @@
+#include "MetaHash.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace meta
+{
+	namespace internal
+	{
+		static const uint64_t c_prime1 = 0x9E3779B185EBCA87ull;
+		static const uint64_t c_prime2 = 0xC2B2AE3D27D4EB4Full;
+		static const uint64_t c_prime3 = 0x165667B19E3779F9ull;
+		static const uint64_t c_prime4 = 0x85EBCA77C2B2AE63ull;
+		static const uint64_t c_prime5 = 0x27D4EB2F165667C5ull;
+
+		static inline uint64_t RotateLeft(uint64_t value, unsigned int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+		static inline uint64_t Read64(const unsigned char* data) { uint64_t value; std::memcpy(&value, data, 8); return value; }
+		static inline uint32_t Read32(const unsigned char* data) { uint32_t value; std::memcpy(&value, data, 4); return value; }
+
+		static inline uint64_t Round(uint64_t acc, uint64_t input)
+		{
+			acc += input * c_prime2;
+			return RotateLeft(acc, 31) * c_prime1;
+		}
+
+		static inline uint64_t MergeRound(uint64_t acc, uint64_t value)
+		{
+			acc ^= Round(0, value);
+			return acc * c_prime1 + c_prime4;
+		}
+
+		// The xxHash64 construction.
+		uint64_t HashBytes(const void* data, size_t size, uint64_t seed)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			const unsigned char* end = bytes + size;
+			uint64_t hash;
+
+			if(size >= 32)
+			{
+				uint64_t v1 = seed + c_prime1 + c_prime2;
+				uint64_t v2 = seed + c_prime2;
+				uint64_t v3 = seed;
+				uint64_t v4 = seed - c_prime1;
+				for(; bytes + 32 <= end; bytes += 32)
+				{
+					v1 = Round(v1, Read64(bytes));
+					v2 = Round(v2, Read64(bytes + 8));
+					v3 = Round(v3, Read64(bytes + 16));
+					v4 = Round(v4, Read64(bytes + 24));
+				}
+
+				hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+				hash = MergeRound(hash, v1);
+				hash = MergeRound(hash, v2);
+				hash = MergeRound(hash, v3);
+				hash = MergeRound(hash, v4);
+			}
+			else
+			{
+				hash = seed + c_prime5;
+			}
+
+			hash += size;
+			for(; bytes + 8 <= end; bytes += 8)
+			{
+				hash ^= Round(0, Read64(bytes));
+				hash = RotateLeft(hash, 27) * c_prime1 + c_prime4;
+			}
+			if(bytes + 4 <= end)
+			{
+				hash ^= Read32(bytes) * c_prime1;
+				hash = RotateLeft(hash, 23) * c_prime2 + c_prime3;
+				bytes += 4;
+			}
+			for(; bytes < end; ++bytes)
+			{
+				hash ^= *bytes * c_prime5;
+				hash = RotateLeft(hash, 11) * c_prime1;
+			}
+
+			hash ^= hash >> 33;
+			hash *= c_prime2;
+			hash ^= hash >> 29;
+			hash *= c_prime3;
+			hash ^= hash >> 32;
+			return hash;
+		}
+
+		// A type flattened into byte spans and leaf members that need their own std::hash/operator==.
+		// float and double members stay in their spans, and are listed as slots so they can be compared as values.
+		struct HashOp
+		{
+			size_t m_offset;
+			size_t m_size;
+			const TypeData* m_type;		// null for a span
+			size_t m_firstSlot;			// a span's float slots are [m_firstSlot, m_firstSlot + m_slotCount) in the plan
+			size_t m_slotCount;
+		};
+
+		// A float or a double in a span, in offset order.
+		struct FloatSlot
+		{
+			uint32_t m_offset;
+			uint32_t m_size;
+		};
+
+		// Built once per type. Members without std::hash (operator==) are found here, and named when Hash() (Equal())
+		// is called instead of failing part way through.
+		struct HashPlan
+		{
+			std::vector<HashOp> m_ops;
+			std::vector<FloatSlot> m_slots;
+			std::string m_unhashable;
+			std::string m_uncomparable;
+		};
+
+		static void AddLeaf(HashPlan& plan, const std::string& name, const TypeData* type, size_t offset, size_t size)
+		{
+			if(!(type->GetFlags() & TypeLifecycle::F_TriviallyCopyable))
+			{
+				if(!type->GetLifecycle().m_hash && plan.m_unhashable.empty())
+				{
+					plan.m_unhashable = name;
+				}
+				if(!type->GetLifecycle().m_equal && plan.m_uncomparable.empty())
+				{
+					plan.m_uncomparable = name;
+				}
+				plan.m_ops.push_back(HashOp{ offset, size, type, 0, 0 });
+				return;
+			}
+
+			if(!plan.m_ops.empty() && !plan.m_ops.back().m_type && plan.m_ops.back().m_offset + plan.m_ops.back().m_size == offset)
+			{
+				plan.m_ops.back().m_size += size;
+			}
+			else
+			{
+				plan.m_ops.push_back(HashOp{ offset, size, nullptr, plan.m_slots.size(), 0 });
+			}
+
+			size_t floatSize = type == Get<float>() ? sizeof(float) : type == Get<double>() ? sizeof(double) : 0;
+			for(size_t at = 0; floatSize && at < size; at += floatSize)
+			{
+				plan.m_slots.push_back(FloatSlot{ (uint32_t)(offset + at), (uint32_t)floatSize });
+				++plan.m_ops.back().m_slotCount;
+			}
+		}
+
+		static void BuildPlan(HashPlan& plan, const TypeData* type, const std::string& prefix, size_t offset)
+		{
+			std::vector<const Member*> members(type->GetMembers().begin(), type->GetMembers().end());
+			std::stable_sort(members.begin(), members.end(), [](const Member* a, const Member* b) { return a->GetOffset() < b->GetOffset(); });
+
+			for(const Member* member : members)
+			{
+				const TypeData* memberType = member->GetStorageType();
+				std::string name = prefix + member->GetName();
+				if(!memberType->GetMembers().empty())
+				{
+					BuildPlan(plan, memberType, name + ".", offset + member->GetOffset());
+				}
+				else
+				{
+					AddLeaf(plan, name, memberType, offset + member->GetOffset(), member->GetSize());
+				}
+			}
+		}
+
+		static HashPlan MakePlan(const TypeData* type)
+		{
+			HashPlan plan;
+			if(type->GetMembers().empty())
+			{
+				AddLeaf(plan, type->GetName(), type, 0, type->GetSize());
+			}
+			else
+			{
+				BuildPlan(plan, type, std::string(), 0);
+			}
+			return plan;
+		}
+
+		// Plans of registered types are built once, and found by the type's index in the registry.
+		static std::atomic<const HashPlan*> g_plans[TYPEDATA_CONTAINER_SIZE];
+
+		static std::mutex& PlanMutex()
+		{
+			static std::mutex s_mutex;
+			return s_mutex;
+		}
+
+		template <typename F>
+		static auto WithPlan(const TypeData* type, F body) -> decltype(body(std::declval<const HashPlan&>()))
+		{
+			const std::vector<TypeData>& storage = *TypeData::GetTypeDataStorage();
+			if(storage.empty() || type < &storage.front() || type > &storage.back())
+			{
+				return body(MakePlan(type));
+			}
+
+			std::atomic<const HashPlan*>& slot = g_plans[type - &storage.front()];
+			const HashPlan* plan = slot.load(std::memory_order_acquire);
+			if(!plan)
+			{
+				std::lock_guard<std::mutex> lock(PlanMutex());
+				plan = slot.load(std::memory_order_relaxed);
+				if(!plan)
+				{
+					plan = new HashPlan(MakePlan(type));
+					slot.store(plan, std::memory_order_release);
+				}
+			}
+			return body(*plan);
+		}
+
+		template <typename Bits>
+		static bool IsNegativeZero(const unsigned char* at)
+		{
+			Bits bits;
+			std::memcpy(&bits, at, sizeof(Bits));
+			return bits == Bits(1) << (sizeof(Bits) * 8 - 1);
+		}
+
+		template <typename F>
+		static bool EqualValues(const unsigned char* a, const unsigned char* b)
+		{
+			F left, right;
+			std::memcpy(&left, a, sizeof(F));
+			std::memcpy(&right, b, sizeof(F));
+			return left == right;
+		}
+
+		// -0 is the only float whose bytes differ from those of an equal value.
+		static bool HasNegativeZero(const HashPlan& plan, const HashOp& span, const unsigned char* bytes)
+		{
+			bool found = false;
+			for(size_t s = span.m_firstSlot; s < span.m_firstSlot + span.m_slotCount; ++s)
+			{
+				const FloatSlot& slot = plan.m_slots[s];
+				found |= slot.m_size == sizeof(float) ? IsNegativeZero<uint32_t>(bytes + slot.m_offset) :
+					IsNegativeZero<uint64_t>(bytes + slot.m_offset);
+			}
+			return found;
+		}
+
+		// Hashes a copy of the span with 0 in place of each -0.
+		static uint64_t HashNormalizedSpan(const HashPlan& plan, const HashOp& span, const unsigned char* bytes, uint64_t hash)
+		{
+			std::vector<unsigned char> copy(bytes + span.m_offset, bytes + span.m_offset + span.m_size);
+			for(size_t s = span.m_firstSlot; s < span.m_firstSlot + span.m_slotCount; ++s)
+			{
+				const FloatSlot& slot = plan.m_slots[s];
+				if(slot.m_size == sizeof(float) ? IsNegativeZero<uint32_t>(bytes + slot.m_offset) :
+					IsNegativeZero<uint64_t>(bytes + slot.m_offset))
+				{
+					std::memset(copy.data() + (slot.m_offset - span.m_offset), 0, slot.m_size);
+				}
+			}
+			return HashBytes(copy.data(), copy.size(), hash);
+		}
+
+		// Spans are hashed as their bytes. So that equal values hash equal, a span holding a -0 is hashed normalized.
+		static uint64_t HashSpan(const HashPlan& plan, const HashOp& span, const unsigned char* bytes, uint64_t hash)
+		{
+			if(span.m_slotCount && HasNegativeZero(plan, span, bytes))
+			{
+				return HashNormalizedSpan(plan, span, bytes, hash);
+			}
+			return HashBytes(bytes + span.m_offset, span.m_size, hash);
+		}
+
+		// Bytes between a span's float slots are compared with memcmp, the slots with ==.
+		static bool EqualSpan(const HashPlan& plan, const HashOp& span, const unsigned char* left, const unsigned char* right)
+		{
+			size_t at = span.m_offset;
+			for(size_t s = span.m_firstSlot; s < span.m_firstSlot + span.m_slotCount; ++s)
+			{
+				const FloatSlot& slot = plan.m_slots[s];
+				if(std::memcmp(left + at, right + at, slot.m_offset - at) != 0 ||
+					!(slot.m_size == sizeof(float) ? EqualValues<float>(left + slot.m_offset, right + slot.m_offset) :
+						EqualValues<double>(left + slot.m_offset, right + slot.m_offset)))
+				{
+					return false;
+				}
+				at = slot.m_offset + slot.m_size;
+			}
+			return std::memcmp(left + at, right + at, span.m_offset + span.m_size - at) == 0;
+		}
+
+		static void CheckHashable(const HashPlan& plan, const char* function)
+		{
+			if(!plan.m_unhashable.empty())
+			{
+				throw std::invalid_argument(std::string(function) + ", member " + plan.m_unhashable + " has no std::hash");
+			}
+		}
+
+		static uint64_t HashWithPlan(const HashPlan& plan, const void* instance)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(instance);
+
+			uint64_t hash = 0;
+			for(const HashOp& op : plan.m_ops)
+			{
+				if(!op.m_type)
+				{
+					hash = HashSpan(plan, op, bytes, hash);
+					continue;
+				}
+
+				uint64_t memberHash = op.m_type->GetLifecycle().m_hash(bytes + op.m_offset);
+				hash = HashBytes(&memberHash, sizeof(memberHash), hash);
+			}
+			return hash;
+		}
+	}
+
+	uint64_t Hash(const TypeData* type, const void* instance)
+	{
+		return internal::WithPlan(type, [&](const internal::HashPlan& plan) 
+		{ 
+			internal::CheckHashable(plan, "meta::Hash()");
+			return internal::HashWithPlan(plan, instance); 
+		});
+	}
+
+	bool Equal(const TypeData* type, const void* a, const void* b)
+	{
+		return internal::WithPlan(type, [&](const internal::HashPlan& plan) -> bool
+		{
+			if(!plan.m_uncomparable.empty())
+			{
+				throw std::invalid_argument("meta::Equal(), member " + plan.m_uncomparable + " has no operator==");
+			}
+
+			const unsigned char* left = static_cast<const unsigned char*>(a);
+			const unsigned char* right = static_cast<const unsigned char*>(b);
+
+			for(const internal::HashOp& op : plan.m_ops)
+			{
+				bool equal = op.m_type ? op.m_type->GetLifecycle().m_equal(left + op.m_offset, right + op.m_offset) :
+					internal::EqualSpan(plan, op, left, right);
+				if(!equal)
+				{
+					return false;
+				}
+			}
+			return true;
+		});
+	}
+
+	void HashBatch(const TypeData* type, const void* objects, size_t count, uint64_t* hashes)
+	{
+		internal::WithPlan(type, [&](const internal::HashPlan& plan)
+		{
+			const unsigned char* base = static_cast<const unsigned char*>(objects);
+			size_t stride = type->GetSize();
+
+			// Throw here rather than on a worker thread.
+			internal::CheckHashable(plan, "meta::HashBatch()");
+
+			auto hashRange = [&](size_t first, size_t last)
+			{
+				for(size_t i = first; i < last; ++i)
+				{
+					hashes[i] = internal::HashWithPlan(plan, base + i * stride);
+				}
+			};
+
+			unsigned int threads = std::thread::hardware_concurrency();
+			if(count < (1 << 14) || threads < 2)
+			{
+				hashRange(0, count);
+				return;
+			}
+
+			size_t perThread = (count + threads - 1) / threads;
+			std::vector<std::thread> workers;
+			for(size_t first = 0; first < count; first += perThread)
+			{
+				workers.emplace_back(hashRange, first, std::min(count, first + perThread));
+			}
+			for(std::thread& worker : workers)
+			{
+				worker.join();
+			}
+		});
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// Hashing and equality for any registered type, generated from its member list.
+// Members are compared field by field, padding is never read. Runs of adjacent trivially copyable members are
+// hashed and compared in bulk, so a padding-free POD is a single span. Members of reflected types are expanded
+// recursively; other members use their type's lifecycle hash and operator==: std::hash for strings, and element by
+// element for containers and pairs of hashable values (std::vector<int>, std::map<std::string, float>, ...).
+// float and double members compare as values, so 0.0f equals -0.0f and a NaN equals nothing. Other trivially copyable
+// members, including floats inside an unexpanded primitive, are compared bitwise.
+// A member with neither (a container of unhashable elements) is found when the type's plan is built; Hash() and
+// Equal() then throw naming it.
+
+#include "Meta.h"
+#include <cstdint>
+#include <vector>
+
+namespace meta
+{
+	// Throw std::invalid_argument if a member can't be hashed (compared).
+	uint64_t Hash(const TypeData* type, const void* instance);
+	bool Equal(const TypeData* type, const void* a, const void* b);
+
+	// Hashes count objects of type into hashes[0, count). Large batches are split across threads.
+	void HashBatch(const TypeData* type, const void* objects, size_t count, uint64_t* hashes);
+
+	template <typename T>
+	uint64_t Hash(const T& instance) { return Hash(Get<T>(), &instance); }
+
+	template <typename T>
+	bool Equal(const T& a, const T& b) { return Equal(Get<T>(), &a, &b); }
+
+	// For std::unordered_map<Key, Value, meta::Hasher<Key>, meta::EqualTo<Key>>
+	template <typename T>
+	struct Hasher
+	{
+		size_t operator()(const T& instance) const { return (size_t)Hash(instance); }
+	};
+
+	template <typename T>
+	struct EqualTo
+	{
+		bool operator()(const T& a, const T& b) const { return Equal(a, b); }
+	};
+
+	namespace internal
+	{
+		// 64-bit hash of a byte range, four 8-byte lanes at a time.
+		uint64_t HashBytes(const void* data, size_t size, uint64_t seed);
+	}
+}
@@ -0,0 +1,186 @@
+#include "MetaInstrumentation.h"
+#include "Meta.h"
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+namespace meta
+{
+	namespace instrumentation
+	{
+		namespace internal
+		{
+			std::atomic<bool> g_enabled(false);
+			double g_nsPerTick = 1.0;
+			std::atomic<unsigned int> g_samplePeriod(16);
+
+			// Methods register from static initializers, so these are constructed on first use.
+			static std::mutex& RegistryMutex()
+			{
+				static std::mutex s_mutex;
+				return s_mutex;
+			}
+
+			static std::vector<const Method*>& MethodRegistry()
+			{
+				static std::vector<const Method*> s_methods;
+				return s_methods;
+			}
+
+			// ThreadStats outlive their threads, so Report() still sees their calls.
+			static std::vector<ThreadStats*>& ThreadRegistry()
+			{
+				static std::vector<ThreadStats*> s_threads;
+				return s_threads;
+			}
+
+			unsigned int RegisterMethod(const Method* method)
+			{
+				std::lock_guard<std::mutex> lock(RegistryMutex());
+				MethodRegistry().push_back(method);
+
+				unsigned int index = (unsigned int)MethodRegistry().size() - 1;
+				assert(index < c_chunkSize * c_maxChunks && "Too many instrumented methods, raise c_maxChunks.");
+				return index;
+			}
+
+			ThreadStats* AttachThread()
+			{
+				ThreadStats* stats = new ThreadStats();
+				for(unsigned int i = 0; i < c_maxChunks; ++i)
+				{
+					stats->m_chunks[i].store(nullptr, std::memory_order_relaxed);
+				}
+
+				std::lock_guard<std::mutex> lock(RegistryMutex());
+				ThreadRegistry().push_back(stats);
+				t_threadStats = stats;
+				return stats;
+			}
+
+			CallCounters* AllocateChunk(ThreadStats* stats, unsigned int chunk)
+			{
+				CallCounters* counters = new CallCounters[c_chunkSize];
+				for(unsigned int i = 0; i < c_chunkSize; ++i)
+				{
+					counters[i].m_calls.store(0, std::memory_order_relaxed);
+					counters[i].m_sampledCalls.store(0, std::memory_order_relaxed);
+					counters[i].m_totalNs.store(0, std::memory_order_relaxed);
+					for(unsigned int b = 0; b < c_histogramBuckets; ++b)
+					{
+						counters[i].m_histogram[b].store(0, std::memory_order_relaxed);
+					}
+				}
+
+				stats->m_chunks[chunk].store(counters, std::memory_order_release);
+				return counters;
+			}
+
+			// Measures ReadTicks() against steady_clock.
+			static double MeasureNsPerTick()
+			{
+				typedef std::chrono::steady_clock clock;
+
+				clock::time_point start = clock::now();
+				uint64_t startTicks = ReadTicks();
+				while(clock::now() - start < std::chrono::milliseconds(10))
+				{
+				}
+				uint64_t ticks = ReadTicks() - startTicks;
+				double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+				return ticks ? ns / ticks : 1.0;
+			}
+
+			double CalibrateNsPerTick()
+			{
+				static std::once_flag s_calibrated;
+				std::call_once(s_calibrated, []() { g_nsPerTick = MeasureNsPerTick(); });
+				return g_nsPerTick;
+			}
+		}
+
+		void SetEnabled(bool enabled)
+		{
+			if(enabled)
+			{
+				internal::CalibrateNsPerTick();
+			}
+			internal::g_enabled.store(enabled, std::memory_order_release);
+		}
+
+		bool IsEnabled()
+		{
+			return internal::g_enabled.load(std::memory_order_relaxed);
+		}
+
+		void SetSamplePeriod(unsigned int period)
+		{
+			internal::g_samplePeriod.store(period ? period : 1, std::memory_order_relaxed);
+		}
+
+		std::vector<MethodStats> Report()
+		{
+			using namespace internal;
+
+			std::lock_guard<std::mutex> lock(RegistryMutex());
+			const std::vector<const Method*>& methods = MethodRegistry();
+
+			std::vector<MethodStats> report;
+			for(unsigned int index = 0; index < methods.size(); ++index)
+			{
+				MethodStats stats = {};
+				for(ThreadStats* thread : ThreadRegistry())
+				{
+					CallCounters* chunk = thread->m_chunks[index / c_chunkSize].load(std::memory_order_acquire);
+					if(!chunk)
+					{
+						continue;
+					}
+
+					CallCounters& counters = chunk[index % c_chunkSize];
+					stats.m_calls += counters.m_calls.load(std::memory_order_relaxed);
+					stats.m_sampledCalls += counters.m_sampledCalls.load(std::memory_order_relaxed);
+					stats.m_totalNs += counters.m_totalNs.load(std::memory_order_relaxed);
+					for(unsigned int b = 0; b < c_histogramBuckets; ++b)
+					{
+						stats.m_histogram[b] += counters.m_histogram[b].load(std::memory_order_relaxed);
+					}
+				}
+
+				if(stats.m_calls == 0)
+				{
+					continue;
+				}
+
+				const Method* method = methods[index];
+				stats.m_typeName = method->GetOwner() ? method->GetOwner()->GetNameStr() : std::string();
+				stats.m_methodName = method->GetNameStr();
+				report.push_back(stats);
+			}
+
+			return report;
+		}
+
+		void PrintReport(std::ostream& out)
+		{
+			for(const MethodStats& stats : Report())
+			{
+				out << stats.m_typeName << "::" << stats.m_methodName 
+					<< "  calls: " << stats.m_calls 
+					<< "  sampled: " << stats.m_sampledCalls
+					<< "  mean: " << (stats.m_sampledCalls ? (double)stats.m_totalNs / stats.m_sampledCalls : 0.0) << "ns" 
+					<< "  histogram (log2 ns):";
+
+				for(unsigned int b = 0; b < c_histogramBuckets; ++b)
+				{
+					if(stats.m_histogram[b])
+					{
+						out << " [" << b << "]=" << stats.m_histogram[b];
+					}
+				}
+				out << std::endl;
+			}
+		}
+	}
+}
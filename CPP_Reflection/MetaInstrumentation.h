@@ -0,0 +1,177 @@
+#pragma once
+
+// Per-Method call counts and latency histograms.
+// Compiled in with META_INSTRUMENTATION=1 (CMake option META_INSTRUMENTATION), 
+// then switched on at runtime with meta::instrumentation::SetEnabled(true).
+// When compiled out, Method carries no extra state and calls are untouched.
+// Every call is counted; latency is timed on one call in SetSamplePeriod() per thread,
+// since reading the cycle counter twice costs more than the counting.
+
+#ifndef META_INSTRUMENTATION
+#define META_INSTRUMENTATION 0
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+	#include <x86intrin.h>
+#endif
+
+namespace meta
+{
+	class Method;
+
+	namespace instrumentation
+	{
+		static const unsigned int c_histogramBuckets = 32;
+
+		struct MethodStats
+		{
+			std::string m_typeName;
+			std::string m_methodName;
+			uint64_t m_calls;
+
+			// Over the timed (sampled) calls only.
+			uint64_t m_sampledCalls;
+			uint64_t m_totalNs;
+
+			// m_histogram[0] counts sampled calls under 2ns, m_histogram[i] those in [2^i, 2^(i+1)) ns.
+			uint64_t m_histogram[c_histogramBuckets];
+		};
+
+		// Runtime switch. Enabling calibrates the cycle counter the first time.
+		void SetEnabled(bool enabled);
+		bool IsEnabled();
+
+		// Time one call in period (per thread). 1 times every call. Defaults to 16.
+		void SetSamplePeriod(unsigned int period);
+
+		// Aggregates the counters of every thread (including exited ones). Methods never called are left out.
+		std::vector<MethodStats> Report();
+		void PrintReport(std::ostream& out);
+
+		namespace internal
+		{
+			static const unsigned int c_chunkSize = 64;
+			static const unsigned int c_maxChunks = 256;
+
+			// Written only by the owning thread, read by Report(); relaxed atomics keep that race free.
+			struct CallCounters
+			{
+				std::atomic<uint64_t> m_calls;
+				std::atomic<uint64_t> m_sampledCalls;
+				std::atomic<uint64_t> m_totalNs;
+				std::atomic<uint64_t> m_histogram[c_histogramBuckets];
+			};
+
+			// One per thread. Counters for method index i live in m_chunks[i / c_chunkSize], allocated on first call.
+			struct ThreadStats
+			{
+				std::atomic<CallCounters*> m_chunks[c_maxChunks];
+			};
+
+			extern std::atomic<bool> g_enabled;
+			extern double g_nsPerTick;
+			extern std::atomic<unsigned int> g_samplePeriod;
+			inline thread_local ThreadStats* t_threadStats = nullptr;
+			inline thread_local unsigned int t_sampleCountdown = 1;
+
+			unsigned int RegisterMethod(const Method* method);
+
+			// Nanoseconds per ReadTicks() tick, measured on the first call (takes ~10ms).
+			double CalibrateNsPerTick();
+			ThreadStats* AttachThread();
+			CallCounters* AllocateChunk(ThreadStats* stats, unsigned int chunk);
+
+			inline uint64_t ReadTicks()
+			{
+			#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+				return __rdtsc();
+			#else
+				return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			#endif
+			}
+
+			// floor(log2(ns)), clamped to the last bucket
+			inline unsigned int HistogramBucket(uint64_t ns)
+			{
+			#if defined(_MSC_VER)
+				unsigned long bucket;
+				_BitScanReverse64(&bucket, ns | 1);
+			#else
+				unsigned int bucket = 63 - __builtin_clzll(ns | 1);
+			#endif
+				return bucket < c_histogramBuckets ? bucket : c_histogramBuckets - 1;
+			}
+
+			inline void Bump(std::atomic<uint64_t>& counter, uint64_t amount)
+			{
+				counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+			}
+
+			inline CallCounters& GetCounters(unsigned int index)
+			{
+				ThreadStats* stats = t_threadStats ? t_threadStats : AttachThread();
+
+				CallCounters* chunk = stats->m_chunks[index / c_chunkSize].load(std::memory_order_relaxed);
+				if(!chunk)
+				{
+					chunk = AllocateChunk(stats, index / c_chunkSize);
+				}
+				return chunk[index % c_chunkSize];
+			}
+
+			inline void RecordLatency(CallCounters& counters, uint64_t ticks)
+			{
+				uint64_t ns = static_cast<uint64_t>(ticks * g_nsPerTick);
+				Bump(counters.m_sampledCalls, 1);
+				Bump(counters.m_totalNs, ns);
+				Bump(counters.m_histogram[HistogramBucket(ns)], 1);
+			}
+
+			// Counts the enclosing call, and times it when sampled, if instrumentation is enabled.
+			class CallScope
+			{
+				CallCounters* m_counters;
+				uint64_t m_start;
+
+			public:
+				explicit CallScope(unsigned int index) : m_counters(nullptr), m_start(0)
+				{
+					if(g_enabled.load(std::memory_order_acquire))
+					{
+						m_counters = &GetCounters(index);
+						Bump(m_counters->m_calls, 1);
+
+						if(--t_sampleCountdown == 0)
+						{
+							t_sampleCountdown = g_samplePeriod.load(std::memory_order_relaxed);
+							m_start = ReadTicks();
+						}
+					}
+				}
+
+				~CallScope()
+				{
+					if(m_start)
+					{
+						RecordLatency(*m_counters, ReadTicks() - m_start);
+					}
+				}
+			};
+		}
+	}
+}
+
+#if META_INSTRUMENTATION
+	#define META_INSTRUMENT_CALL(method) meta::instrumentation::internal::CallScope metaCallScope((method)->GetStatsIndex())
+#else
+	#define META_INSTRUMENT_CALL(method)
+#endif
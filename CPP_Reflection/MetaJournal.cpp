@@ -0,0 +1,177 @@
+#include "MetaJournal.h"
+#include <cstring>
+
+namespace meta
+{
+	Journal::Journal(size_t chunkBytes) :
+		m_chunkBytes(chunkBytes),
+		m_end{ 0, 0 },
+		m_current(0),
+		m_open(false),
+		m_openStep{ { 0, 0 }, 0 },
+		m_lastEntry(nullptr)
+	{}
+
+	void Journal::WriteBytes(void* object, const Member* member, const void* value)
+	{
+		if(!(member->GetStorageType()->GetFlags() & TypeLifecycle::F_TriviallyCopyable))
+		{
+			throw std::invalid_argument("Journal::WriteBytes(), member is not trivially copyable");
+		}
+
+		unsigned char* at = static_cast<unsigned char*>(member->GetPointer(object));
+		uint32_t offset = (uint32_t)member->GetOffset();
+		uint32_t size = (uint32_t)member->GetSize();
+
+		if(m_open && m_lastEntry->m_object == object && m_lastEntry->m_offset == offset && m_lastEntry->m_size == size)
+		{
+			// keeps the old bytes from before the first of the writes
+			std::memcpy(reinterpret_cast<unsigned char*>(m_lastEntry + 1) + size, value, size);
+			std::memmove(at, value, size);
+			return;
+		}
+
+		if(!m_open)
+		{
+			DiscardRedo();
+			m_open = true;
+			m_openStep = Step{ m_end, 0 };
+		}
+
+		unsigned char* entry = Append(EntryBytes(size));
+		EntryHeader* header = reinterpret_cast<EntryHeader*>(entry);
+		header->m_object = object;
+		header->m_offset = offset;
+		header->m_size = size;
+		std::memcpy(entry + sizeof(EntryHeader), at, size);
+		std::memcpy(entry + sizeof(EntryHeader) + size, value, size);
+		std::memmove(at, value, size);
+
+		m_lastEntry = header;
+		++m_openStep.m_entries;
+	}
+
+	void Journal::Commit()
+	{
+		if(!m_open)
+		{
+			return;
+		}
+
+		m_openStep.m_end = m_end;
+		m_steps.push_back(m_openStep);
+		m_current = m_steps.size();
+		m_open = false;
+		m_lastEntry = nullptr;
+	}
+
+	bool Journal::Undo()
+	{
+		Commit();
+		if(m_current == 0)
+		{
+			return false;
+		}
+
+		Entries(--m_current, m_scratch);
+		for(auto entry = m_scratch.rbegin(); entry != m_scratch.rend(); ++entry)
+		{
+			EntryHeader* header = *entry;
+			std::memcpy(static_cast<unsigned char*>(header->m_object) + header->m_offset, header + 1, header->m_size);
+		}
+		return true;
+	}
+
+	bool Journal::Redo()
+	{
+		if(!CanRedo())
+		{
+			return false;
+		}
+
+		Entries(m_current++, m_scratch);
+		for(EntryHeader* header : m_scratch)
+		{
+			std::memcpy(static_cast<unsigned char*>(header->m_object) + header->m_offset, 
+				reinterpret_cast<unsigned char*>(header + 1) + header->m_size, header->m_size);
+		}
+		return true;
+	}
+
+	void Journal::Clear()
+	{
+		for(Chunk& chunk : m_chunks)
+		{
+			chunk.m_used = 0;
+		}
+		m_end = Position{ 0, 0 };
+		m_steps.clear();
+		m_current = 0;
+		m_open = false;
+		m_lastEntry = nullptr;
+	}
+
+	size_t Journal::GetBytesUsed() const
+	{
+		size_t used = 0;
+		for(const Chunk& chunk : m_chunks)
+		{
+			used += chunk.m_used;
+		}
+		return used;
+	}
+
+	unsigned char* Journal::Append(size_t bytes)
+	{
+		if(m_end.m_chunk >= m_chunks.size() || m_chunks[m_end.m_chunk].m_size - m_end.m_offset < bytes)
+		{
+			// the first chunk, or the next one (reused if it's big enough)
+			size_t next = m_end.m_chunk < m_chunks.size() ? m_end.m_chunk + 1 : m_end.m_chunk;
+			if(next == m_chunks.size() || m_chunks[next].m_size < bytes)
+			{
+				size_t size = bytes > m_chunkBytes ? bytes : m_chunkBytes;
+				m_chunks.insert(m_chunks.begin() + next, Chunk{ std::unique_ptr<unsigned char[]>(new unsigned char[size]), size, 0 });
+			}
+			m_end = Position{ (uint32_t)next, 0 };
+		}
+
+		Chunk& chunk = m_chunks[m_end.m_chunk];
+		unsigned char* at = chunk.m_data.get() + m_end.m_offset;
+		m_end.m_offset += (uint32_t)bytes;
+		chunk.m_used = m_end.m_offset;
+		return at;
+	}
+
+	void Journal::DiscardRedo()
+	{
+		if(m_current == m_steps.size())
+		{
+			return;
+		}
+
+		m_steps.resize(m_current);
+		m_end = m_steps.empty() ? Position{ 0, 0 } : m_steps.back().m_end;
+		for(size_t c = m_end.m_chunk; c < m_chunks.size(); ++c)
+		{
+			m_chunks[c].m_used = c == m_end.m_chunk ? m_end.m_offset : 0;
+		}
+	}
+
+	void Journal::Entries(size_t step, std::vector<EntryHeader*>& entries) const
+	{
+		entries.clear();
+
+		Position at = step ? m_steps[step - 1].m_end : Position{ 0, 0 };
+		for(uint32_t e = 0; e < m_steps[step].m_entries; ++e)
+		{
+			while(at.m_offset >= m_chunks[at.m_chunk].m_used)
+			{
+				at = Position{ at.m_chunk + 1, 0 };
+			}
+
+			EntryHeader* header = reinterpret_cast<EntryHeader*>(m_chunks[at.m_chunk].m_data.get() + at.m_offset);
+			entries.push_back(header);
+			at.m_offset += (uint32_t)EntryBytes(header->m_size);
+		}
+	}
+}
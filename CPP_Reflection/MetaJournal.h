@@ -0,0 +1,123 @@
+#pragma once
+
+// Undo/redo of member writes, recorded member by member instead of as object snapshots.
+// Journal::Write() writes a member and records an entry of the object, the member's offset, and its old and new
+// bytes, so an edit costs its changed bytes plus a 16 byte header whatever the object's size. Writes are grouped into
+// steps by Commit(); writing the member just written again (dragging a slider) updates its entry instead of adding one.
+// Entries are appended to fixed size chunks that never move, so a long session doesn't stall on a reallocation.
+// Undo() and Redo() copy the recorded bytes back at the recorded offsets.
+// Only trivially copyable members can be journaled (their bytes are their value), and the objects must outlive their
+// entries, or be forgotten with Clear().
+
+#include "Meta.h"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace meta
+{
+	class Journal
+	{
+	public:
+		static const size_t c_defaultChunkBytes = 64 * 1024;
+
+		explicit Journal(size_t chunkBytes = c_defaultChunkBytes);
+
+		Journal(const Journal&) = delete;
+		Journal& operator=(const Journal&) = delete;
+
+		// Writes member->GetSize() bytes from value to member of object. Throws std::invalid_argument for a member that
+		// isn't trivially copyable. Discards the steps that could have been redone.
+		void WriteBytes(void* object, const Member* member, const void* value);
+
+		// Also throws std::invalid_argument if T isn't the member's type (an int written to a float member).
+		template <typename T>
+		void Write(void* object, const Member* member, const T& value)
+		{
+			if(!IsMemberType<T>(member, std::is_pointer<T>()))
+			{
+				throw std::invalid_argument("Journal::Write(), value is not of the member's type");
+			}
+			WriteBytes(object, member, &value);
+		}
+
+		// Ends the current step. Does nothing if there were no writes since the last Commit().
+		void Commit();
+
+		// Undo() reverts the last applied step, committing the current one first; Redo() reapplies the last undone one.
+		// Both return false if there's none.
+		bool Undo();
+		bool Redo();
+
+		bool CanUndo() const { return m_current > 0 || m_open; }
+		bool CanRedo() const { return !m_open && m_current < m_steps.size(); }
+
+		// Forgets every step. Keeps the chunks for reuse.
+		void Clear();
+
+		size_t GetStepCount() const { return m_steps.size(); }
+
+		// Bytes of the recorded entries, and of the chunks holding them.
+		size_t GetBytesUsed() const;
+		size_t GetBytesReserved() const { return m_chunks.size() * m_chunkBytes; }
+
+	private:
+		// Followed by m_size old bytes, then m_size new bytes, padded to 8.
+		struct EntryHeader
+		{
+			void* m_object;
+			uint32_t m_offset;
+			uint32_t m_size;
+		};
+
+		struct Chunk
+		{
+			std::unique_ptr<unsigned char[]> m_data;
+			size_t m_size;
+			size_t m_used;
+		};
+
+		struct Position
+		{
+			uint32_t m_chunk;
+			uint32_t m_offset;
+		};
+
+		// A step's entries run from the previous step's m_end to its own.
+		struct Step
+		{
+			Position m_end;
+			uint32_t m_entries;
+		};
+
+		static size_t EntryBytes(uint32_t size) { return (sizeof(EntryHeader) + 2 * (size_t)size + 7) & ~(size_t)7; }
+
+		// Pointer members are stored as void*, and typed by their pointee.
+		template <typename T>
+		static bool IsMemberType(const Member* member, std::false_type) { return Get<T>() == member->GetStorageType(); }
+
+		template <typename T>
+		static bool IsMemberType(const Member* member, std::true_type) 
+		{ 
+			return member->IsPointer() && Get<typename std::remove_cv<typename std::remove_pointer<T>::type>::type>() == member->GetType(); 
+		}
+
+		unsigned char* Append(size_t bytes);
+		void DiscardRedo();
+		void Entries(size_t step, std::vector<EntryHeader*>& entries) const;
+
+		size_t m_chunkBytes;
+		std::vector<Chunk> m_chunks;
+		Position m_end;					// where the next entry goes
+
+		std::vector<Step> m_steps;
+		size_t m_current;				// steps [0, m_current) are applied, the rest can be redone
+
+		bool m_open;					// writes since the last Commit() form m_openStep, after the last step
+		Step m_openStep;
+		EntryHeader* m_lastEntry;		// the open step's last entry, to coalesce into
+
+		std::vector<EntryHeader*> m_scratch;
+	};
+}
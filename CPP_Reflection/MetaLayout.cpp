@@ -0,0 +1,151 @@
+#include "MetaLayout.h"
+#include <algorithm>
+#include <ostream>
+
+namespace meta
+{
+	static size_t AlignUp(size_t offset, size_t alignment)
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+
+	static size_t LayoutStart(const TypeData* type)
+	{
+		return (type->GetFlags() & TypeLifecycle::F_Polymorphic) ? sizeof(void*) : 0;
+	}
+
+	TypeLayout GetLayout(const TypeData* type)
+	{
+		TypeLayout layout;
+		layout.m_type = type;
+		layout.m_size = type->GetSize();
+		layout.m_alignment = type->GetAlignment();
+		layout.m_flags = type->GetFlags();
+		layout.m_paddingBytes = 0;
+
+		for(const Member* member : type->GetMembers())
+		{
+			layout.m_members.push_back(MemberLayout{ member, member->GetOffset(), member->GetSize(), member->GetAlignment() });
+		}
+		std::stable_sort(layout.m_members.begin(), layout.m_members.end(), 
+			[](const MemberLayout& a, const MemberLayout& b) { return a.m_offset < b.m_offset; });
+
+		size_t cursor = LayoutStart(type);
+		for(const MemberLayout& member : layout.m_members)
+		{
+			if(member.m_offset > cursor)
+			{
+				layout.m_holes.push_back(PaddingHole{ cursor, member.m_offset - cursor });
+			}
+			cursor = std::max(cursor, member.m_offset + member.m_size);
+		}
+		if(layout.m_size > cursor)
+		{
+			layout.m_holes.push_back(PaddingHole{ cursor, layout.m_size - cursor });
+		}
+
+		for(const PaddingHole& hole : layout.m_holes)
+		{
+			layout.m_paddingBytes += hole.m_size;
+		}
+		return layout;
+	}
+
+	// Padding is always smaller than the alignment it pads to. A bigger hole holds something unreflected,
+	// a field or a base class, so the type's true minimum size isn't known.
+	static bool HolesArePadding(const TypeLayout& layout)
+	{
+		for(const PaddingHole& hole : layout.m_holes)
+		{
+			size_t padsTo = layout.m_alignment;
+			for(const MemberLayout& member : layout.m_members)
+			{
+				if(member.m_offset == hole.m_offset + hole.m_size)
+				{
+					padsTo = member.m_alignment;
+					break;
+				}
+			}
+
+			if(hole.m_size >= padsTo)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<LayoutSuggestion> AnalyzeLayouts(size_t instanceCount)
+	{
+		std::vector<LayoutSuggestion> suggestions;
+
+		for(const TypeData& type : *TypeData::GetTypeDataStorage())
+		{
+			if(type.GetMembers().empty())
+			{
+				continue;
+			}
+
+			TypeLayout layout = GetLayout(&type);
+			if(layout.m_paddingBytes == 0 || !HolesArePadding(layout))
+			{
+				continue;
+			}
+
+			std::vector<MemberLayout> order = layout.m_members;
+			std::stable_sort(order.begin(), order.end(), 
+				[](const MemberLayout& a, const MemberLayout& b) { return a.m_alignment > b.m_alignment; });
+
+			size_t offset = LayoutStart(&type);
+			for(const MemberLayout& member : order)
+			{
+				offset = AlignUp(offset, member.m_alignment) + member.m_size;
+			}
+			size_t suggestedSize = AlignUp(offset, layout.m_alignment);
+
+			if(suggestedSize >= layout.m_size)
+			{
+				continue;
+			}
+
+			LayoutSuggestion suggestion;
+			suggestion.m_type = &type;
+			suggestion.m_currentSize = layout.m_size;
+			suggestion.m_suggestedSize = suggestedSize;
+			suggestion.m_paddingBytes = layout.m_paddingBytes;
+			suggestion.m_bytesSaved = (layout.m_size - suggestedSize) * instanceCount;
+			for(const MemberLayout& member : order)
+			{
+				suggestion.m_order.push_back(member.m_member);
+			}
+			suggestions.push_back(suggestion);
+		}
+
+		std::stable_sort(suggestions.begin(), suggestions.end(), 
+			[](const LayoutSuggestion& a, const LayoutSuggestion& b) { return a.m_bytesSaved > b.m_bytesSaved; });
+		return suggestions;
+	}
+
+	void PrintLayoutReport(std::ostream& out, size_t instanceCount)
+	{
+		size_t totalSaved = 0;
+		for(const LayoutSuggestion& suggestion : AnalyzeLayouts(instanceCount))
+		{
+			out << suggestion.m_type->GetName() 
+				<< "  size: " << suggestion.m_currentSize 
+				<< "  padding: " << suggestion.m_paddingBytes 
+				<< "  reordered: " << suggestion.m_suggestedSize
+				<< "  saves " << suggestion.m_bytesSaved << " bytes per " << instanceCount << " instances" << std::endl
+				<< "    order:";
+
+			for(const Member* member : suggestion.m_order)
+			{
+				out << " " << member->GetName();
+			}
+			out << std::endl;
+
+			totalSaved += suggestion.m_bytesSaved;
+		}
+		out << "Total: " << totalSaved << " bytes saved per " << instanceCount << " instances of each type" << std::endl;
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+// Memory layout of reflected types, and an analyzer that finds padding across the registry.
+// Only reflected members are known, so unreflected fields and base classes show up as holes.
+
+#include "Meta.h"
+#include <iosfwd>
+#include <vector>
+
+namespace meta
+{
+	struct MemberLayout
+	{
+		const Member* m_member;
+		size_t m_offset;
+		size_t m_size;
+		size_t m_alignment;
+	};
+
+	struct PaddingHole
+	{
+		size_t m_offset;
+		size_t m_size;
+	};
+
+	struct TypeLayout
+	{
+		const TypeData* m_type;
+		size_t m_size;
+		size_t m_alignment;
+		unsigned int m_flags;				// TypeLifecycle::Flags
+		std::vector<MemberLayout> m_members;	// by offset
+		std::vector<PaddingHole> m_holes;	// bytes not covered by a member (or the vtable pointer), tail padding included
+		size_t m_paddingBytes;
+	};
+
+	TypeLayout GetLayout(const TypeData* type);
+
+	// A member order with less padding: by decreasing alignment, the vtable pointer first.
+	struct LayoutSuggestion
+	{
+		const TypeData* m_type;
+		size_t m_currentSize;
+		size_t m_suggestedSize;
+		size_t m_paddingBytes;
+		std::vector<const Member*> m_order;
+		size_t m_bytesSaved;	// over the instance count given to AnalyzeLayouts()
+	};
+
+	// Suggestions for every registered type that reordering makes smaller, most bytes saved first.
+	std::vector<LayoutSuggestion> AnalyzeLayouts(size_t instanceCount);
+	void PrintLayoutReport(std::ostream& out, size_t instanceCount);
+}
@@ -0,0 +1,535 @@
+#include "MetaLog.h"
+#include "MetaMigration.h"
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace meta
+{
+	namespace logging
+	{
+		namespace internal
+		{
+			std::atomic<uint64_t> g_dropped(0);
+
+			static const char c_magic[4] = { 'M', 'L', 'O', 'G' };
+			static const uint32_t c_version = 1;
+
+			// Record timestamps are printed relative to this, taken when the first thread attaches.
+			static std::atomic<uint64_t> g_epochTicks(0);
+
+			static std::mutex& RegistryMutex()
+			{
+				static std::mutex s_mutex;
+				return s_mutex;
+			}
+
+			// ThreadLogs outlive their threads, so a drain still sees their last records, and are then reused.
+			static std::vector<ThreadLog*>& ThreadRegistry()
+			{
+				static std::vector<ThreadLog*> s_threads;
+				return s_threads;
+			}
+
+			// Frees the thread's log when the thread exits.
+			struct ThreadLogRelease
+			{
+				~ThreadLogRelease()
+				{
+					if(t_threadLog)
+					{
+						t_threadLog->m_exited.store(true, std::memory_order_release);
+						t_threadLog = nullptr;
+					}
+				}
+			};
+
+			ThreadLog* AttachThread()
+			{
+				if(t_threadLog)
+				{
+					return t_threadLog;
+				}
+				static thread_local ThreadLogRelease s_release;
+
+				static uint32_t s_nextThreadId = 0;
+				std::lock_guard<std::mutex> lock(RegistryMutex());
+				if(ThreadRegistry().empty())
+				{
+					instrumentation::internal::CalibrateNsPerTick();
+					g_epochTicks.store(instrumentation::internal::ReadTicks(), std::memory_order_relaxed);
+				}
+
+				// A drained log of an exited thread keeps its ring positions; only its thread id changes.
+				ThreadLog* log = nullptr;
+				for(ThreadLog* candidate : ThreadRegistry())
+				{
+					if(candidate->m_exited.load(std::memory_order_acquire) && 
+						candidate->m_tail.load(std::memory_order_acquire) == candidate->m_head.load(std::memory_order_relaxed))
+					{
+						log = candidate;
+						break;
+					}
+				}
+
+				if(!log)
+				{
+					log = new ThreadLog();
+					log->m_head.store(0, std::memory_order_relaxed);
+					log->m_tail.store(0, std::memory_order_relaxed);
+					ThreadRegistry().push_back(log);
+				}
+				log->m_threadId = s_nextThreadId++;
+				log->m_exited.store(false, std::memory_order_relaxed);
+				t_threadLog = log;
+				return log;
+			}
+
+			/*****/ //  Plans  //
+
+			// The plan, and the fields of the payload it produces: Schema fields, at their offsets in the payload.
+			struct TypeLog : LogPlan
+			{
+				std::string m_typeName;
+				std::vector<Schema::Field> m_fields;
+			};
+
+			static TypeLog* MakePlan(const TypeData* type, uint32_t typeIndex)
+			{
+				std::unique_ptr<TypeLog> plan(new TypeLog());
+				plan->m_typeIndex = typeIndex;
+				plan->m_typeName = type->GetName();
+
+				Schema schema = Schema::Of(type);
+				plan->m_memcpy = (type->GetFlags() & TypeLifecycle::F_TriviallyCopyable) != 0;
+				if(plan->m_memcpy)
+				{
+					plan->m_payloadSize = (uint32_t)type->GetSize();
+					plan->m_fields = schema.GetFields();
+					if(type->GetMembers().empty())
+					{
+						// a primitive is its own only field
+						plan->m_fields.push_back(Schema::Field{ std::string(), plan->m_typeName, 0, plan->m_payloadSize });
+					}
+				}
+				else
+				{
+					uint32_t payloadSize = 0;
+					for(const Schema::Field& field : schema.GetFields())
+					{
+						if(!plan->m_spans.empty() && plan->m_spans.back().m_offset + plan->m_spans.back().m_size == field.m_offset)
+						{
+							plan->m_spans.back().m_size += field.m_size;
+						}
+						else
+						{
+							plan->m_spans.push_back(LogPlan::Span{ field.m_offset, field.m_size });
+						}
+
+						plan->m_fields.push_back(Schema::Field{ field.m_name, field.m_typeName, payloadSize, field.m_size });
+						payloadSize += field.m_size;
+					}
+					plan->m_payloadSize = payloadSize;
+				}
+
+				if(AlignRecord(sizeof(RecordHeader) + plan->m_payloadSize) > c_logBufferBytes / 2)
+				{
+					throw std::invalid_argument("meta::logging::Log(), type is too large for META_LOG_BUFFER_BYTES");
+				}
+				return plan.release();
+			}
+
+			// Plans of registered types are built once, and found by the type's index in the registry.
+			static std::atomic<const TypeLog*> g_plans[TYPEDATA_CONTAINER_SIZE];
+
+			static std::mutex& PlanMutex()
+			{
+				static std::mutex s_mutex;
+				return s_mutex;
+			}
+
+			const LogPlan& GetPlan(const TypeData* type)
+			{
+				const std::vector<TypeData>& storage = *TypeData::GetTypeDataStorage();
+				if(storage.empty() || type < &storage.front() || type > &storage.back())
+				{
+					throw std::invalid_argument("meta::logging::Log(), type is not registered");
+				}
+
+				uint32_t typeIndex = (uint32_t)(type - &storage.front());
+				std::atomic<const TypeLog*>& slot = g_plans[typeIndex];
+				const TypeLog* plan = slot.load(std::memory_order_acquire);
+				if(!plan)
+				{
+					std::lock_guard<std::mutex> lock(PlanMutex());
+					plan = slot.load(std::memory_order_relaxed);
+					if(!plan)
+					{
+						plan = MakePlan(type, typeIndex);
+						slot.store(plan, std::memory_order_release);
+					}
+				}
+				return *plan;
+			}
+
+			/*****/ //  Binary format  //
+			// "MLOG", version, ns per tick, epoch ticks, then the logged types, then the records. Native byte order.
+
+			template <typename T> void Write(std::ostream& out, const T& value)
+			{
+				out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+			}
+
+			static void WriteString(std::ostream& out, const std::string& str)
+			{
+				Write(out, (uint32_t)str.size());
+				out.write(str.data(), str.size());
+			}
+
+			template <typename T> bool Read(std::istream& in, T& value)
+			{
+				return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+			}
+
+			static bool ReadString(std::istream& in, std::string& str)
+			{
+				uint32_t size;
+				if(!Read(in, size) || size > (1u << 16))
+				{
+					return false;
+				}
+				str.resize(size);
+				return size == 0 || (bool)in.read(&str[0], size);
+			}
+
+			// A thread's pending records, as they were laid out in its ring from m_start on.
+			struct PendingRecords
+			{
+				uint32_t m_threadId;
+				uint64_t m_start;
+				std::vector<unsigned char> m_bytes;
+			};
+
+			// Only one drain runs at a time.
+			static std::mutex& DrainMutex()
+			{
+				static std::mutex s_mutex;
+				return s_mutex;
+			}
+
+			// Copies out the pending records of every thread into pending, and frees their space in the rings. pending
+			// is reused from drain to drain, so its buffers are already paged in.
+			static void Take(std::vector<PendingRecords>& pending)
+			{
+				std::vector<ThreadLog*> threads;
+				{
+					std::lock_guard<std::mutex> lock(RegistryMutex());
+					threads = ThreadRegistry();
+				}
+
+				size_t used = 0;
+				for(ThreadLog* log : threads)
+				{
+					uint64_t tail = log->m_tail.load(std::memory_order_relaxed);
+					uint64_t head = log->m_head.load(std::memory_order_acquire);
+					if(tail == head)
+					{
+						continue;
+					}
+
+					if(used == pending.size())
+					{
+						pending.emplace_back();
+					}
+					PendingRecords& records = pending[used++];
+					records.m_threadId = log->m_threadId;
+					records.m_start = tail;
+					records.m_bytes.resize(head - tail);
+
+					// at most two pieces, the second from the start of the ring
+					uint32_t at = (uint32_t)(tail % c_logBufferBytes);
+					uint64_t first = head - tail < c_logBufferBytes - at ? head - tail : c_logBufferBytes - at;
+					std::memcpy(records.m_bytes.data(), log->m_buffer + at, first);
+					std::memcpy(records.m_bytes.data() + first, log->m_buffer, head - tail - first);
+
+					log->m_tail.store(head, std::memory_order_release);
+				}
+				pending.resize(used);
+			}
+
+			// Calls visit(header, payload) on each record.
+			template <typename F>
+			static void ForEachRecord(const PendingRecords& records, F visit)
+			{
+				size_t offset = 0;
+				while(offset < records.m_bytes.size())
+				{
+					RecordHeader header;
+					std::memcpy(&header, records.m_bytes.data() + offset, sizeof(header));
+
+					if(header.m_typeIndex == c_wrapMarker)
+					{
+						offset += c_logBufferBytes - (size_t)((records.m_start + offset) % c_logBufferBytes);
+						continue;
+					}
+
+					visit(header, records.m_bytes.data() + offset + sizeof(header));
+					offset += AlignRecord(sizeof(header) + header.m_size);
+				}
+			}
+
+			/*****/ //  Formatting  //
+
+			template <typename T> bool FormatAs(std::ostream& out, const unsigned char* bytes, uint32_t size)
+			{
+				if(size != sizeof(T))
+				{
+					return false;
+				}
+
+				T value;
+				std::memcpy(&value, bytes, sizeof(T));
+				out << +value;
+				return true;
+			}
+
+			// Known primitives print as values, the rest as hex bytes.
+			static void FormatField(std::ostream& out, const std::string& type, const unsigned char* bytes, uint32_t size)
+			{
+				if((type == "int" && FormatAs<int>(out, bytes, size)) ||
+					(type == "float" && FormatAs<float>(out, bytes, size)) ||
+					(type == "double" && FormatAs<double>(out, bytes, size)) ||
+					(type == "char" && FormatAs<char>(out, bytes, size)) ||
+					(type == "long long" && FormatAs<long long>(out, bytes, size)))
+				{
+					return;
+				}
+
+				static const char c_hex[] = "0123456789abcdef";
+				out << "0x";
+				for(uint32_t i = 0; i < size; ++i)
+				{
+					out << c_hex[bytes[i] >> 4] << c_hex[bytes[i] & 0xF];
+				}
+			}
+
+			struct TypeEntry
+			{
+				std::string m_name;
+				uint32_t m_payloadSize;
+				std::vector<Schema::Field> m_fields;
+			};
+		}
+
+		void AttachThread()
+		{
+			internal::AttachThread();
+		}
+
+		bool Log(const TypeData* type, const void* object)
+		{
+			return internal::Write(internal::GetPlan(type), object);
+		}
+
+		uint64_t GetDropped()
+		{
+			return internal::g_dropped.load(std::memory_order_relaxed);
+		}
+
+		size_t DrainBinary(std::ostream& out)
+		{
+			using namespace internal;
+
+			std::lock_guard<std::mutex> lock(DrainMutex());
+			static std::vector<PendingRecords> s_pending;
+			static std::string s_block;
+			std::vector<PendingRecords>& pending = s_pending;
+			Take(pending);
+
+			// Types are numbered in the file in the order they're first seen.
+			std::vector<uint32_t> typeIds(TYPEDATA_CONTAINER_SIZE, UINT32_MAX);
+			std::vector<const TypeLog*> types;
+			uint64_t recordCount = 0;
+			for(const PendingRecords& records : pending)
+			{
+				ForEachRecord(records, [&](const RecordHeader& header, const unsigned char*)
+				{
+					if(typeIds[header.m_typeIndex] == UINT32_MAX)
+					{
+						typeIds[header.m_typeIndex] = (uint32_t)types.size();
+						types.push_back(g_plans[header.m_typeIndex].load(std::memory_order_acquire));
+					}
+					++recordCount;
+				});
+			}
+
+			out.write(c_magic, sizeof(c_magic));
+			Write(out, c_version);
+			Write(out, instrumentation::internal::CalibrateNsPerTick());
+			Write(out, g_epochTicks.load(std::memory_order_relaxed));
+
+			Write(out, (uint32_t)types.size());
+			for(const TypeLog* type : types)
+			{
+				WriteString(out, type->m_typeName);
+				Write(out, type->m_payloadSize);
+				Write(out, (uint32_t)type->m_fields.size());
+				for(const Schema::Field& field : type->m_fields)
+				{
+					WriteString(out, field.m_name);
+					WriteString(out, field.m_typeName);
+					Write(out, field.m_offset);
+					Write(out, field.m_size);
+				}
+			}
+
+			Write(out, recordCount);
+			std::string& block = s_block;
+			for(const PendingRecords& records : pending)
+			{
+				// a record's header is the same size in the file as in the ring, and its padding is dropped
+				block.resize(records.m_bytes.size());
+				char* at = &block[0];
+				ForEachRecord(records, [&](const RecordHeader& header, const unsigned char* payload)
+				{
+					std::memcpy(at, &typeIds[header.m_typeIndex], sizeof(uint32_t));
+					std::memcpy(at + 4, &records.m_threadId, sizeof(uint32_t));
+					std::memcpy(at + 8, &header.m_ticks, sizeof(uint64_t));
+					std::memcpy(at + 16, payload, header.m_size);
+					at += 16 + header.m_size;
+				});
+				out.write(block.data(), at - block.data());
+			}
+
+			return (size_t)recordCount;
+		}
+
+		size_t Drain(std::ostream& out)
+		{
+			std::stringstream binary;
+			size_t count = DrainBinary(binary);
+			FormatBinary(binary, out);
+			return count;
+		}
+
+		bool FormatBinary(std::istream& in, std::ostream& out)
+		{
+			using namespace internal;
+
+			char magic[4];
+			uint32_t version;
+			double nsPerTick;
+			uint64_t epochTicks;
+			if(!in.read(magic, sizeof(magic)) || std::memcmp(magic, c_magic, sizeof(magic)) != 0 ||
+				!Read(in, version) || version != c_version || !Read(in, nsPerTick) || !Read(in, epochTicks))
+			{
+				return false;
+			}
+
+			uint32_t typeCount;
+			if(!Read(in, typeCount))
+			{
+				return false;
+			}
+
+			std::vector<TypeEntry> types(typeCount);
+			for(TypeEntry& type : types)
+			{
+				uint32_t fieldCount;
+				if(!ReadString(in, type.m_name) || !Read(in, type.m_payloadSize) || !Read(in, fieldCount) || fieldCount > (1u << 16))
+				{
+					return false;
+				}
+
+				type.m_fields.resize(fieldCount);
+				for(Schema::Field& field : type.m_fields)
+				{
+					if(!ReadString(in, field.m_name) || !ReadString(in, field.m_typeName) ||
+						!Read(in, field.m_offset) || !Read(in, field.m_size) ||
+						field.m_offset > type.m_payloadSize || field.m_size > type.m_payloadSize - field.m_offset)
+					{
+						return false;
+					}
+				}
+			}
+
+			uint64_t recordCount;
+			if(!Read(in, recordCount))
+			{
+				return false;
+			}
+
+			std::vector<unsigned char> payload;
+			for(uint64_t r = 0; r < recordCount; ++r)
+			{
+				uint32_t typeId;
+				uint32_t threadId;
+				uint64_t ticks;
+				if(!Read(in, typeId) || typeId >= typeCount || !Read(in, threadId) || !Read(in, ticks))
+				{
+					return false;
+				}
+
+				const TypeEntry& type = types[typeId];
+				payload.resize(type.m_payloadSize);
+				if(type.m_payloadSize && !in.read(reinterpret_cast<char*>(payload.data()), type.m_payloadSize))
+				{
+					return false;
+				}
+
+				out << "[" << (uint64_t)((ticks - epochTicks) * nsPerTick) << " ns] thread " << threadId << ": " << type.m_name << " {";
+				for(size_t f = 0; f < type.m_fields.size(); ++f)
+				{
+					const Schema::Field& field = type.m_fields[f];
+					out << (f ? ", " : " ");
+					if(!field.m_name.empty())
+					{
+						out << field.m_name << " = ";
+					}
+					FormatField(out, field.m_typeName, payload.data() + field.m_offset, field.m_size);
+				}
+				out << " }\n";
+			}
+			out.flush();
+
+			return true;
+		}
+
+		/*****/ //  BackgroundDrain  //
+
+		BackgroundDrain::BackgroundDrain(std::ostream& out, std::chrono::milliseconds period) :
+			m_out(out), m_period(period), m_stop(false), m_thread(&BackgroundDrain::Run, this)
+		{}
+
+		BackgroundDrain::~BackgroundDrain()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stop = true;
+			}
+			m_wake.notify_one();
+			m_thread.join();
+		}
+
+		void BackgroundDrain::Run()
+		{
+			for(;;)
+			{
+				bool stop;
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_wake.wait_for(lock, m_period, [this]() { return m_stop; });
+					stop = m_stop;
+				}
+
+				Drain(m_out);
+				if(stop)
+				{
+					return;
+				}
+			}
+		}
+	}
+}
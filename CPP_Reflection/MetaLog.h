@@ -0,0 +1,168 @@
+#pragma once
+
+// Structured logging of reflected objects, formatted later.
+// Log() copies the object's bytes and its type into the calling thread's ring buffer and returns: no formatting, no
+// locks, and after the thread's first record (or logging::AttachThread()), no allocation. A trivially copyable object
+// is a single memcpy. Other types copy the spans of their Schema fields (see MetaMigration.h), planned once per type,
+// so strings and pointers aren't logged.
+// Records are formatted on whichever thread drains them: Drain() formats them as text, and DrainBinary() writes them
+// with a description of each logged type, so FormatBinary() can format them offline without the types registered.
+// Each thread's buffer has one writer (its thread) and one reader (the drain, serialized with a lock). When it's full,
+// records are dropped and counted in GetDropped(). Once its thread has exited and its records are drained, a buffer is
+// reused by the next thread that attaches, so there are only as many buffers as threads ever logged at once.
+
+#ifndef META_LOG_BUFFER_BYTES
+#define META_LOG_BUFFER_BYTES (1 << 20)
+#endif
+
+#include "Meta.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace meta
+{
+	namespace logging
+	{
+		static const uint32_t c_logBufferBytes = META_LOG_BUFFER_BYTES;
+
+		// Returns false if the record was dropped (the buffer is full). Throws std::invalid_argument if type isn't
+		// registered, or its records wouldn't fit the buffer.
+		bool Log(const TypeData* type, const void* object);
+
+		template <typename T>
+		bool Log(const T& object) { return Log(Get<T>(), &object); }
+
+		// Allocates the calling thread's buffer up front, so its first record doesn't.
+		void AttachThread();
+
+		// Takes every thread's pending records, oldest first per thread. Return the number of records taken.
+		size_t Drain(std::ostream& out);
+		size_t DrainBinary(std::ostream& out);
+
+		// Formats a DrainBinary() file as Drain() would have. Returns false if the input isn't a log.
+		bool FormatBinary(std::istream& in, std::ostream& out);
+
+		// Records dropped because a buffer was full.
+		uint64_t GetDropped();
+
+		// Drains into out every period on its own thread, and once more when destroyed.
+		class BackgroundDrain
+		{
+			std::ostream& m_out;
+			std::chrono::milliseconds m_period;
+			std::mutex m_mutex;
+			std::condition_variable m_wake;
+			bool m_stop;
+			std::thread m_thread;
+
+			void Run();
+
+		public:
+			BackgroundDrain(std::ostream& out, std::chrono::milliseconds period = std::chrono::milliseconds(10));
+			~BackgroundDrain();
+
+			BackgroundDrain(const BackgroundDrain&) = delete;
+			BackgroundDrain& operator=(const BackgroundDrain&) = delete;
+		};
+
+		namespace internal
+		{
+			// Header of a record in a ring. Records are 16 byte aligned; a record that would cross the end of the ring
+			// is placed at its start instead, after a header with m_typeIndex c_wrapMarker.
+			struct RecordHeader
+			{
+				uint32_t m_size;		// of the payload
+				uint32_t m_typeIndex;	// in TypeData::GetTypeDataStorage()
+				uint64_t m_ticks;
+			};
+
+			static const uint32_t c_wrapMarker = 0xFFFFFFFF;
+			static_assert(c_logBufferBytes % sizeof(RecordHeader) == 0, "META_LOG_BUFFER_BYTES must be a multiple of 16");
+
+			// m_head is written by the owning thread, m_tail by the drain. Both count bytes since the start.
+			struct ThreadLog
+			{
+				uint32_t m_threadId;
+				std::atomic<bool> m_exited;	// set when the owning thread exits, the log is free once drained
+				alignas(64) std::atomic<uint64_t> m_head;
+				alignas(64) std::atomic<uint64_t> m_tail;
+				alignas(64) unsigned char m_buffer[c_logBufferBytes];
+			};
+
+			// How a type's objects are copied into their records.
+			struct LogPlan
+			{
+				struct Span
+				{
+					uint32_t m_offset;	// in the object, packed back to back in the payload
+					uint32_t m_size;
+				};
+
+				uint32_t m_typeIndex;
+				uint32_t m_payloadSize;
+				bool m_memcpy;			// trivially copyable: the payload is the whole object
+				std::vector<Span> m_spans;
+			};
+
+			extern std::atomic<uint64_t> g_dropped;
+			inline thread_local ThreadLog* t_threadLog = nullptr;
+
+			ThreadLog* AttachThread();
+			const LogPlan& GetPlan(const TypeData* type);
+
+			inline uint32_t AlignRecord(uint32_t size) { return (size + 15) & ~15u; }
+
+			inline bool Write(const LogPlan& plan, const void* object)
+			{
+				ThreadLog* log = t_threadLog ? t_threadLog : AttachThread();
+
+				uint32_t recordSize = AlignRecord(sizeof(RecordHeader) + plan.m_payloadSize);
+				uint64_t head = log->m_head.load(std::memory_order_relaxed);
+				uint32_t at = (uint32_t)(head % c_logBufferBytes);
+				uint32_t skipped = c_logBufferBytes - at < recordSize ? c_logBufferBytes - at : 0;
+
+				if(head + skipped + recordSize - log->m_tail.load(std::memory_order_acquire) > c_logBufferBytes)
+				{
+					g_dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+
+				if(skipped)
+				{
+					RecordHeader marker = { 0, c_wrapMarker, 0 };
+					std::memcpy(log->m_buffer + at, &marker, sizeof(marker));
+					at = 0;
+				}
+
+				RecordHeader header = { plan.m_payloadSize, plan.m_typeIndex, instrumentation::internal::ReadTicks() };
+				unsigned char* record = log->m_buffer + at;
+				std::memcpy(record, &header, sizeof(header));
+
+				const unsigned char* bytes = static_cast<const unsigned char*>(object);
+				if(plan.m_memcpy)
+				{
+					std::memcpy(record + sizeof(header), bytes, plan.m_payloadSize);
+				}
+				else
+				{
+					unsigned char* payload = record + sizeof(header);
+					for(const LogPlan::Span& span : plan.m_spans)
+					{
+						std::memcpy(payload, bytes + span.m_offset, span.m_size);
+						payload += span.m_size;
+					}
+				}
+
+				log->m_head.store(head + skipped + recordSize, std::memory_order_release);
+				return true;
+			}
+		}
+	}
+}
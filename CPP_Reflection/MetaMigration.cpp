@@ -0,0 +1,392 @@
+#include "MetaMigration.h"
+#include "MetaHash.h"
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace meta
+{
+	namespace
+	{
+		/**************************************************/
+		//                     Schema                     //
+		/**************************************************/
+
+		static const uint32_t c_schemaMagic = 0x48435353;	// "SSCH"
+		static const uint32_t c_schemaVersion = 1;
+
+		void Flatten(std::vector<Schema::Field>& fields, const TypeData* type, const std::string& prefix, size_t offset)
+		{
+			std::vector<const Member*> members(type->GetMembers().begin(), type->GetMembers().end());
+			std::stable_sort(members.begin(), members.end(), [](const Member* a, const Member* b) { return a->GetOffset() < b->GetOffset(); });
+
+			for(const Member* member : members)
+			{
+				if(member->IsPointer())
+				{
+					continue;
+				}
+
+				const TypeData* memberType = member->GetType();
+				std::string name = prefix + member->GetName();
+				if(!memberType->GetMembers().empty())
+				{
+					Flatten(fields, memberType, name + ".", offset + member->GetOffset());
+				}
+				else if(memberType->GetFlags() & TypeLifecycle::F_TriviallyCopyable)
+				{
+					fields.push_back(Schema::Field{ name, memberType->GetName(), (uint32_t)(offset + member->GetOffset()), (uint32_t)member->GetSize() });
+				}
+			}
+		}
+
+		void WriteU32(std::ostream& out, uint32_t value)
+		{
+			out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		void WriteString(std::ostream& out, const std::string& value)
+		{
+			WriteU32(out, (uint32_t)value.size());
+			out.write(value.data(), value.size());
+		}
+
+		uint32_t ReadU32(std::istream& in)
+		{
+			uint32_t value;
+			if(!in.read(reinterpret_cast<char*>(&value), sizeof(value)))
+			{
+				throw std::runtime_error("Schema::Read(), truncated schema");
+			}
+			return value;
+		}
+
+		std::string ReadString(std::istream& in)
+		{
+			uint32_t size = ReadU32(in);
+			if(size > (1u << 16))
+			{
+				throw std::runtime_error("Schema::Read(), malformed schema");
+			}
+
+			std::string value(size, '\0');
+			if(!in.read(&value[0], size))
+			{
+				throw std::runtime_error("Schema::Read(), truncated schema");
+			}
+			return value;
+		}
+
+		/**************************************************/
+		//                     Copies                     //
+		/**************************************************/
+
+		template <size_t Size>
+		void CopyStrided(const unsigned char* in, size_t inStride, unsigned char* out, size_t outStride, size_t count)
+		{
+			for(size_t i = 0; i < count; ++i)
+			{
+				std::memcpy(out + i * outStride, in + i * inStride, Size);
+			}
+		}
+
+		// Common span sizes get a fixed-size copy instead of a memcpy call per record.
+		void CopyStrided(const unsigned char* in, size_t inStride, unsigned char* out, size_t outStride, size_t count, size_t size)
+		{
+			switch(size)
+			{
+			case 1: CopyStrided<1>(in, inStride, out, outStride, count); break;
+			case 2: CopyStrided<2>(in, inStride, out, outStride, count); break;
+			case 4: CopyStrided<4>(in, inStride, out, outStride, count); break;
+			case 8: CopyStrided<8>(in, inStride, out, outStride, count); break;
+			case 12: CopyStrided<12>(in, inStride, out, outStride, count); break;
+			case 16: CopyStrided<16>(in, inStride, out, outStride, count); break;
+			default:
+				for(size_t i = 0; i < count; ++i)
+				{
+					std::memcpy(out + i * outStride, in + i * inStride, size);
+				}
+			}
+		}
+
+		/**************************************************/
+		//                   Widenings                    //
+		/**************************************************/
+
+		template <typename From, typename To>
+		void Widen(const unsigned char* from, size_t fromStride, unsigned char* to, size_t toStride, size_t count)
+		{
+			for(size_t i = 0; i < count; ++i)
+			{
+				From value;
+				std::memcpy(&value, from + i * fromStride, sizeof(From));
+				To widened = static_cast<To>(value);
+				std::memcpy(to + i * toStride, &widened, sizeof(To));
+			}
+		}
+
+		struct Widening
+		{
+			const char* m_from;
+			const char* m_to;
+			MigrationPlan::WidenFunction m_widen;
+		};
+
+		template <typename From, typename To>
+		Widening MakeWidening()
+		{
+			return Widening{ internal::TypeName<From>::c_str(), internal::TypeName<To>::c_str(), &Widen<From, To> };
+		}
+
+		// The conversions that keep every value.
+		MigrationPlan::WidenFunction FindWidening(const std::string& from, const std::string& to)
+		{
+			static const Widening s_widenings[] =
+			{
+				MakeWidening<char, int>(),
+				MakeWidening<char, long long>(),
+				MakeWidening<char, float>(),
+				MakeWidening<char, double>(),
+				MakeWidening<int, long long>(),
+				MakeWidening<int, double>(),
+				MakeWidening<float, double>(),
+			};
+
+			for(const Widening& widening : s_widenings)
+			{
+				if(from == widening.m_from && to == widening.m_to)
+				{
+					return widening.m_widen;
+				}
+			}
+			return nullptr;
+		}
+	}
+
+	bool Schema::Field::operator==(const Field& rhs) const
+	{
+		return m_name == rhs.m_name && m_typeName == rhs.m_typeName && m_offset == rhs.m_offset && m_size == rhs.m_size;
+	}
+
+	Schema Schema::Of(const TypeData* type)
+	{
+		Schema schema;
+		schema.m_typeName = type->GetName();
+		schema.m_size = (uint32_t)type->GetSize();
+		schema.m_alignment = (uint32_t)type->GetAlignment();
+		Flatten(schema.m_fields, type, std::string(), 0);
+		schema.UpdateFingerprint();
+		return schema;
+	}
+
+	void Schema::Write(std::ostream& out) const
+	{
+		WriteU32(out, c_schemaMagic);
+		WriteU32(out, c_schemaVersion);
+		WriteString(out, m_typeName);
+		WriteU32(out, m_size);
+		WriteU32(out, m_alignment);
+		WriteU32(out, (uint32_t)m_fields.size());
+		for(const Field& field : m_fields)
+		{
+			WriteString(out, field.m_name);
+			WriteString(out, field.m_typeName);
+			WriteU32(out, field.m_offset);
+			WriteU32(out, field.m_size);
+		}
+	}
+
+	Schema Schema::Read(std::istream& in)
+	{
+		if(ReadU32(in) != c_schemaMagic || ReadU32(in) != c_schemaVersion)
+		{
+			throw std::runtime_error("Schema::Read(), not a schema");
+		}
+
+		Schema schema;
+		schema.m_typeName = ReadString(in);
+		schema.m_size = ReadU32(in);
+		schema.m_alignment = ReadU32(in);
+
+		uint32_t fieldCount = ReadU32(in);
+		for(uint32_t i = 0; i < fieldCount; ++i)
+		{
+			Field field;
+			field.m_name = ReadString(in);
+			field.m_typeName = ReadString(in);
+			field.m_offset = ReadU32(in);
+			field.m_size = ReadU32(in);
+			if(field.m_size > schema.m_size || field.m_offset > schema.m_size - field.m_size)
+			{
+				throw std::runtime_error("Schema::Read(), field outside the record");
+			}
+			schema.m_fields.push_back(field);
+		}
+
+		schema.UpdateFingerprint();
+		return schema;
+	}
+
+	bool Schema::operator==(const Schema& rhs) const
+	{
+		return m_fingerprint == rhs.m_fingerprint && m_typeName == rhs.m_typeName && m_size == rhs.m_size 
+			&& m_alignment == rhs.m_alignment && m_fields == rhs.m_fields;
+	}
+
+	void Schema::UpdateFingerprint()
+	{
+		uint64_t hash = internal::HashBytes(m_typeName.data(), m_typeName.size(), 0);
+		uint32_t layout[2] = { m_size, m_alignment };
+		hash = internal::HashBytes(layout, sizeof(layout), hash);
+
+		for(const Field& field : m_fields)
+		{
+			hash = internal::HashBytes(field.m_name.data(), field.m_name.size(), hash);
+			hash = internal::HashBytes(field.m_typeName.data(), field.m_typeName.size(), hash);
+			uint32_t placement[2] = { field.m_offset, field.m_size };
+			hash = internal::HashBytes(placement, sizeof(placement), hash);
+		}
+		m_fingerprint = hash;
+	}
+
+	/**************************************************/
+	//                 MigrationPlan                  //
+	/**************************************************/
+
+	MigrationPlan::MigrationPlan(const Schema& saved, const TypeData* current) : m_saved(saved), m_current(current)
+	{
+		Schema target = Schema::Of(current);
+		std::vector<bool> used(saved.GetFields().size(), false);
+
+		for(const Schema::Field& field : target.GetFields())
+		{
+			const std::vector<Schema::Field>& savedFields = saved.GetFields();
+			size_t match = std::find_if(savedFields.begin(), savedFields.end(), [&](const Schema::Field& f) { return f.m_name == field.m_name; }) - savedFields.begin();
+			if(match == savedFields.size())
+			{
+				m_defaulted.push_back(field.m_name);
+				continue;
+			}
+
+			const Schema::Field& from = savedFields[match];
+			if(from.m_typeName == field.m_typeName && from.m_size == field.m_size)
+			{
+				m_steps.push_back(Step{ from.m_offset, field.m_offset, field.m_size, nullptr });
+			}
+			else if(WidenFunction widen = FindWidening(from.m_typeName, field.m_typeName))
+			{
+				m_steps.push_back(Step{ from.m_offset, field.m_offset, 0, widen });
+			}
+			else
+			{
+				m_defaulted.push_back(field.m_name);
+				continue;
+			}
+			used[match] = true;
+		}
+
+		for(size_t i = 0; i < used.size(); ++i)
+		{
+			if(!used[i])
+			{
+				m_dropped.push_back(saved.GetFields()[i].m_name);
+			}
+		}
+
+		// Copies that are adjacent on both sides become one span.
+		std::stable_sort(m_steps.begin(), m_steps.end(), [](const Step& a, const Step& b) { return a.m_to < b.m_to; });
+
+		std::vector<Step> merged;
+		for(const Step& step : m_steps)
+		{
+			if(!merged.empty() && step.m_size && merged.back().m_size 
+				&& merged.back().m_from + merged.back().m_size == step.m_from && merged.back().m_to + merged.back().m_size == step.m_to)
+			{
+				merged.back().m_size += step.m_size;
+			}
+			else
+			{
+				merged.push_back(step);
+			}
+		}
+		m_steps.swap(merged);
+	}
+
+	void MigrationPlan::Apply(const void* records, size_t count, void* objects) const
+	{
+		// Blocks keep the records being converted in cache while each step runs over them.
+		const size_t c_blockRecords = 256;
+
+		const unsigned char* source = static_cast<const unsigned char*>(records);
+		unsigned char* destination = static_cast<unsigned char*>(objects);
+		size_t sourceStride = m_saved.GetSize();
+		size_t stride = m_current->GetSize();
+
+		// Same layout: one copy per block.
+		bool whole = m_steps.size() == 1 && m_steps[0].m_size == stride && sourceStride == stride && m_steps[0].m_from == 0 && m_steps[0].m_to == 0;
+
+		// Only construction can throw, and it cleans up its own block.
+		size_t done = 0;
+		try
+		{
+			while(done < count)
+			{
+				size_t block = std::min(c_blockRecords, count - done);
+				const unsigned char* from = source + done * sourceStride;
+				unsigned char* to = destination + done * stride;
+
+				m_current->ConstructArray(to, block);
+				done += block;
+
+				if(whole)
+				{
+					std::memcpy(to, from, block * stride);
+					continue;
+				}
+
+				for(const Step& step : m_steps)
+				{
+					const unsigned char* in = from + step.m_from;
+					unsigned char* out = to + step.m_to;
+					if(step.m_size)
+					{
+						CopyStrided(in, sourceStride, out, stride, block, step.m_size);
+					}
+					else
+					{
+						step.m_widen(in, sourceStride, out, stride, block);
+					}
+				}
+			}
+		}
+		catch(...)
+		{
+			m_current->DestroyArray(destination, done);
+			throw;
+		}
+	}
+
+	const MigrationPlan& GetMigrationPlan(const Schema& saved, const TypeData* current)
+	{
+		static std::mutex s_mutex;
+		static std::unordered_map<uint64_t, std::vector<std::unique_ptr<MigrationPlan>>> s_plans;
+
+		std::lock_guard<std::mutex> lock(s_mutex);
+		std::vector<std::unique_ptr<MigrationPlan>>& bucket = s_plans[saved.GetFingerprint() ^ current->GetNameHash()];
+		for(const std::unique_ptr<MigrationPlan>& plan : bucket)
+		{
+			if(plan->GetCurrent() == current && plan->GetSaved() == saved)
+			{
+				return *plan;
+			}
+		}
+
+		bucket.emplace_back(new MigrationPlan(saved, current));
+		return *bucket.back();
+	}
+}
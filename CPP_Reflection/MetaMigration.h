@@ -0,0 +1,113 @@
+#pragma once
+
+// Converts records saved with an older layout of a type into its current layout.
+// A Schema records a type's layout: its leaf members (members of reflected value members are flattened to
+// "outer.inner"), with their type names, offsets and sizes. Saved next to the records, it's all that's needed to
+// read them back after the type has changed.
+// Migrating compiles a MigrationPlan once per (saved schema, current type) pair, matching members by name and type:
+// matches become byte copies (adjacent ones merged into one span) or widenings (char -> int -> long long -> double,
+// float -> double), and the rest of the current members keep their default constructed values. Saved members with
+// no match are dropped. Applying a plan does no lookups, so it's meant for large batches of records.
+// Only trivially copyable, non-pointer leaves are part of a schema; others (strings, pointers) are default constructed.
+
+#include "Meta.h"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace meta
+{
+	class Schema
+	{
+	public:
+		struct Field
+		{
+			std::string m_name;
+			std::string m_typeName;
+			uint32_t m_offset;
+			uint32_t m_size;
+
+			bool operator==(const Field& rhs) const;
+		};
+
+		Schema() : m_size(0), m_alignment(1), m_fingerprint(0) {}
+
+		// The current layout of a registered type.
+		static Schema Of(const TypeData* type);
+
+		// Binary form. Read throws std::runtime_error on a truncated or malformed stream.
+		void Write(std::ostream& out) const;
+		static Schema Read(std::istream& in);
+
+		const std::string& GetTypeName() const { return m_typeName; }
+		const std::vector<Field>& GetFields() const { return m_fields; }
+		uint32_t GetSize() const { return m_size; }
+		uint32_t GetAlignment() const { return m_alignment; }
+
+		// Hash of everything above, equal for equal schemas.
+		uint64_t GetFingerprint() const { return m_fingerprint; }
+
+		bool operator==(const Schema& rhs) const;
+		bool operator!=(const Schema& rhs) const { return !(*this == rhs); }
+
+	private:
+		void UpdateFingerprint();
+
+		std::string m_typeName;
+		uint32_t m_size;
+		uint32_t m_alignment;
+		std::vector<Field> m_fields;
+		uint64_t m_fingerprint;
+	};
+
+	class MigrationPlan
+	{
+	public:
+		// Converts count strided values.
+		typedef void (*WidenFunction)(const unsigned char* from, size_t fromStride, unsigned char* to, size_t toStride, size_t count);
+
+		struct Step
+		{
+			uint32_t m_from;	// offset in the saved record
+			uint32_t m_to;		// offset in the current object
+			uint32_t m_size;	// of the copied span, 0 for a widening
+			WidenFunction m_widen;
+		};
+
+		MigrationPlan(const Schema& saved, const TypeData* current);
+
+		// Constructs count current objects at objects from count saved records, laid out back to back with the
+		// saved schema's size. objects must be suitably aligned, uninitialized storage.
+		void Apply(const void* records, size_t count, void* objects) const;
+
+		const Schema& GetSaved() const { return m_saved; }
+		const TypeData* GetCurrent() const { return m_current; }
+		const std::vector<Step>& GetSteps() const { return m_steps; }
+
+		// Current members left at their default values, and saved members that weren't carried over.
+		const std::vector<std::string>& GetDefaulted() const { return m_defaulted; }
+		const std::vector<std::string>& GetDropped() const { return m_dropped; }
+
+	private:
+		Schema m_saved;
+		const TypeData* m_current;
+		std::vector<Step> m_steps;
+		std::vector<std::string> m_defaulted;
+		std::vector<std::string> m_dropped;
+	};
+
+	// The plan for a pair, compiled on first use and kept for the life of the program.
+	const MigrationPlan& GetMigrationPlan(const Schema& saved, const TypeData* current);
+
+	inline void Migrate(const Schema& saved, const void* records, size_t count, const TypeData* current, void* objects)
+	{
+		GetMigrationPlan(saved, current).Apply(records, count, objects);
+	}
+
+	template <typename T>
+	void Migrate(const Schema& saved, const void* records, size_t count, T* objects)
+	{
+		Migrate(saved, records, count, Get<T>(), objects);
+	}
+}
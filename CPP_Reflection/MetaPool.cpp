@@ -0,0 +1,153 @@
+#include "MetaPool.h"
+#include <atomic>
+#include <new>
+
+namespace meta
+{
+	namespace internal
+	{
+		static std::atomic<unsigned int> g_nextPoolId(0);
+
+		// A thread's free lists, indexed by pool id. Returned to their pools when the thread exits.
+		struct ThreadCache
+		{
+			struct Entry
+			{
+				SlabPool* m_pool;
+				SlabPool::FreeBlock* m_head;
+				unsigned int m_count;
+			};
+
+			std::vector<Entry> m_entries;
+
+			Entry& Get(unsigned int id, SlabPool* pool)
+			{
+				if(id >= m_entries.size())
+				{
+					m_entries.resize(id + 1, Entry{ nullptr, nullptr, 0 });
+				}
+
+				Entry& entry = m_entries[id];
+				entry.m_pool = pool;
+				return entry;
+			}
+
+			~ThreadCache()
+			{
+				for(Entry& entry : m_entries)
+				{
+					if(!entry.m_head)
+					{
+						continue;
+					}
+
+					SlabPool::FreeBlock* tail = entry.m_head;
+					while(tail->m_next)
+					{
+						tail = tail->m_next;
+					}
+					entry.m_pool->ReturnBatch(entry.m_head, tail);
+				}
+			}
+		};
+
+		static thread_local ThreadCache t_cache;
+
+		SlabPool::SlabPool(size_t size, size_t alignment) : 
+			m_id(g_nextPoolId.fetch_add(1, std::memory_order_relaxed)),
+			m_free(nullptr)
+		{
+			// Free blocks hold the free list link.
+			m_alignment = alignment < alignof(FreeBlock) ? alignof(FreeBlock) : alignment;
+			m_blockSize = size < sizeof(FreeBlock) ? sizeof(FreeBlock) : size;
+			m_blockSize = (m_blockSize + m_alignment - 1) / m_alignment * m_alignment;
+
+			m_blocksPerSlab = c_slabBytes / m_blockSize;
+			m_blocksPerSlab = m_blocksPerSlab < c_minBlocksPerSlab ? c_minBlocksPerSlab : m_blocksPerSlab;
+		}
+
+		void* SlabPool::Allocate()
+		{
+			ThreadCache::Entry& entry = t_cache.Get(m_id, this);
+			if(!entry.m_head)
+			{
+				entry.m_count = TakeBatch(entry.m_head, c_batchSize);
+			}
+
+			FreeBlock* block = entry.m_head;
+			entry.m_head = block->m_next;
+			--entry.m_count;
+			return block;
+		}
+
+		void SlabPool::Deallocate(void* block)
+		{
+			ThreadCache::Entry& entry = t_cache.Get(m_id, this);
+
+			FreeBlock* freed = static_cast<FreeBlock*>(block);
+			freed->m_next = entry.m_head;
+			entry.m_head = freed;
+			++entry.m_count;
+
+			// Keep one batch cached, hand the rest back.
+			if(entry.m_count >= 2 * c_batchSize)
+			{
+				FreeBlock* head = entry.m_head;
+				FreeBlock* tail = head;
+				for(unsigned int i = 1; i < c_batchSize; ++i)
+				{
+					tail = tail->m_next;
+				}
+
+				entry.m_head = tail->m_next;
+				entry.m_count -= c_batchSize;
+				tail->m_next = nullptr;
+				ReturnBatch(head, tail);
+			}
+		}
+
+		unsigned int SlabPool::TakeBatch(FreeBlock*& head, unsigned int count)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if(!m_free)
+			{
+				AddSlab();
+			}
+
+			head = m_free;
+			FreeBlock* tail = m_free;
+			unsigned int taken = 1;
+			while(taken < count && tail->m_next)
+			{
+				tail = tail->m_next;
+				++taken;
+			}
+
+			m_free = tail->m_next;
+			tail->m_next = nullptr;
+			return taken;
+		}
+
+		void SlabPool::ReturnBatch(FreeBlock* head, FreeBlock* tail)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			tail->m_next = m_free;
+			m_free = head;
+		}
+
+		// Slabs are never released, pools live as long as their TypeData.
+		void SlabPool::AddSlab()
+		{
+			char* slab = static_cast<char*>(::operator new(m_blockSize * m_blocksPerSlab, std::align_val_t(m_alignment)));
+			m_slabs.push_back(slab);
+
+			for(size_t i = m_blocksPerSlab; i-- > 0; )
+			{
+				FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + i * m_blockSize);
+				block->m_next = m_free;
+				m_free = block;
+			}
+		}
+	}
+}
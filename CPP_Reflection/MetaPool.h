@@ -0,0 +1,51 @@
+#pragma once
+
+// Slab pools that TypeData::Create()/Destroy() allocate instances from.
+// One pool per reflected type that is created, made on its first Create(), with blocks sized and aligned for that type.
+// Each thread keeps a small free list per pool, and only takes the pool's lock to refill or drain it in batches.
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace meta
+{
+	namespace internal
+	{
+		class SlabPool
+		{
+		public:
+			struct FreeBlock { FreeBlock* m_next; };
+
+			static const size_t c_slabBytes = 64 * 1024;
+			static const unsigned int c_minBlocksPerSlab = 8;
+			static const unsigned int c_batchSize = 32;
+
+			SlabPool(size_t size, size_t alignment);
+			SlabPool(const SlabPool&) = delete;
+			SlabPool& operator=(const SlabPool&) = delete;
+
+			void* Allocate();
+			void Deallocate(void* block);
+
+			size_t GetBlockSize() const { return m_blockSize; }
+			size_t GetAlignment() const { return m_alignment; }
+
+			// Used by thread caches: moves up to count blocks from the shared free list into a chain.
+			unsigned int TakeBatch(FreeBlock*& head, unsigned int count);
+			void ReturnBatch(FreeBlock* head, FreeBlock* tail);
+
+		private:
+			void AddSlab();
+
+			unsigned int m_id;
+			size_t m_blockSize;
+			size_t m_alignment;
+			size_t m_blocksPerSlab;
+
+			std::mutex m_mutex;
+			FreeBlock* m_free;
+			std::vector<void*> m_slabs;
+		};
+	}
+}
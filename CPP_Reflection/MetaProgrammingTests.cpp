@@ -1,7 +1,13 @@
 #include "MetaProgrammingTests.h"
 #include "Indices.h"
+#include "expression.h"
 #include <iostream>
 
+static_assert(std::is_same<select_type<2, int, double, float, unsigned int>::type, float>::value, "select_type picked the wrong type.");
+static_assert(std::is_same<expr::detail::type_list<1, int, double>::type, double>::value, "type_list picked the wrong type.");
+static_assert(std::is_same<expr::detail::type_list<2, int, double>::type, void>::value, "type_list out of range should be void.");
+static_assert(std::is_same<build_indices<3>, indices<0, 1, 2>>::value, "build_indices built the wrong sequence.");
+
 void SelectParameterTest()
 {
 	int e = 1;
@@ -0,0 +1,322 @@
+#include "MetaQuery.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+#if defined(_M_X64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define META_QUERY_SSE2 1
+#endif
+
+namespace meta
+{
+	namespace
+	{
+		inline unsigned int CountTrailingZeros(uint64_t bits)
+		{
+		#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward64(&index, bits);
+			return index;
+		#else
+			return __builtin_ctzll(bits);
+		#endif
+		}
+
+		inline unsigned int PopCount(uint64_t bits)
+		{
+		#if defined(_MSC_VER)
+			return (unsigned int)__popcnt64(bits);
+		#else
+			return __builtin_popcountll(bits);
+		#endif
+		}
+
+		// Packs 64 0/1 bytes into a bitmask, byte i to bit i.
+		inline uint64_t PackBits(const uint8_t* hits)
+		{
+			uint64_t mask = 0;
+		#if META_QUERY_SSE2
+			for(unsigned int i = 0; i < 64; i += 16)
+			{
+				__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hits + i));
+				uint64_t bits = (uint64_t)(unsigned int)_mm_movemask_epi8(_mm_cmpgt_epi8(bytes, _mm_setzero_si128()));
+				mask |= bits << i;
+			}
+		#else
+			for(unsigned int i = 0; i < 64; ++i)
+			{
+				mask |= (uint64_t)hits[i] << i;
+			}
+		#endif
+			return mask;
+		}
+
+		template <CompareOp Op> struct Compare;
+		template <> struct Compare<Equals>       { template <typename T> static bool Test(T a, T b) { return a == b; } };
+		template <> struct Compare<NotEquals>    { template <typename T> static bool Test(T a, T b) { return a != b; } };
+		template <> struct Compare<Less>         { template <typename T> static bool Test(T a, T b) { return a < b; } };
+		template <> struct Compare<LessEqual>    { template <typename T> static bool Test(T a, T b) { return a <= b; } };
+		template <> struct Compare<Greater>      { template <typename T> static bool Test(T a, T b) { return a > b; } };
+		template <> struct Compare<GreaterEqual> { template <typename T> static bool Test(T a, T b) { return a >= b; } };
+
+		// Compares branch-free into bytes, then packs the bytes into bits. With AVX2 the column is gathered into
+		// a contiguous block first so the comparison vectorizes, otherwise the strided loads are compared directly.
+		template <typename T, CompareOp Op>
+		uint64_t CompareKernel(const unsigned char* column, size_t stride, size_t count, const Query::Predicate& predicate)
+		{
+			T value;
+			std::memcpy(&value, predicate.m_value, sizeof(T));
+
+			uint8_t hits[64] = {};
+		#if defined(__AVX2__)
+			T block[64];
+			internal::GatherStrided<sizeof(T)>(block, column, stride, count);
+			for(size_t i = 0; i < count; ++i)
+			{
+				hits[i] = Compare<Op>::Test(block[i], value);
+			}
+		#else
+			for(size_t i = 0; i < count; ++i)
+			{
+				T element;
+				std::memcpy(&element, column + i * stride, sizeof(T));
+				hits[i] = Compare<Op>::Test(element, value);
+			}
+		#endif
+			return PackBits(hits);
+		}
+
+		template <typename T>
+		auto SelectKernel(CompareOp op) -> decltype(&CompareKernel<T, Equals>)
+		{
+			switch(op)
+			{
+			case Equals:       return &CompareKernel<T, Equals>;
+			case NotEquals:    return &CompareKernel<T, NotEquals>;
+			case Less:         return &CompareKernel<T, Less>;
+			case LessEqual:    return &CompareKernel<T, LessEqual>;
+			case Greater:      return &CompareKernel<T, Greater>;
+			case GreaterEqual: return &CompareKernel<T, GreaterEqual>;
+			}
+			throw std::invalid_argument("Query::Where(), unknown CompareOp");
+		}
+
+		template <typename T>
+		void StoreValue(Query::Predicate& predicate, CompareOp op, T value)
+		{
+			predicate.m_kernel = SelectKernel<T>(op);
+			std::memcpy(predicate.m_value, &value, sizeof(T));
+		}
+
+		uint64_t MatchNone(const unsigned char*, size_t, size_t, const Query::Predicate&)
+		{
+			return 0;
+		}
+
+		uint64_t MatchAll(const unsigned char*, size_t, size_t count, const Query::Predicate&)
+		{
+			return count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+		}
+
+		// Integer members: a fractional or out of range value becomes the equivalent integer bound, or a predicate
+		// that matches every row or none.
+		template <typename T>
+		void StoreIntegerBound(Query::Predicate& predicate, CompareOp op, double value)
+		{
+			const double lowest = (double)std::numeric_limits<T>::lowest();
+			const double highest = (double)std::numeric_limits<T>::max();
+
+			if(std::isnan(value))
+			{
+				predicate.m_kernel = op == NotEquals ? &MatchAll : &MatchNone;
+				return;
+			}
+
+			bool whole = std::floor(value) == value;
+			switch(op)
+			{
+			case Equals:
+			case NotEquals:
+				if(!whole || value < lowest || value > highest)
+				{
+					predicate.m_kernel = op == NotEquals ? &MatchAll : &MatchNone;
+				}
+				else
+				{
+					StoreValue<T>(predicate, op, (T)value);
+				}
+				return;
+
+			// x < v is x <= ceil(v) - 1, x <= v is x <= floor(v)
+			case Less:
+			case LessEqual:
+			{
+				double bound = op == Less ? std::ceil(value) - 1 : std::floor(value);
+				if(bound >= highest)
+				{
+					predicate.m_kernel = &MatchAll;
+				}
+				else if(bound < lowest)
+				{
+					predicate.m_kernel = &MatchNone;
+				}
+				else
+				{
+					StoreValue<T>(predicate, LessEqual, (T)bound);
+				}
+				return;
+			}
+
+			// x > v is x >= floor(v) + 1, x >= v is x >= ceil(v)
+			case Greater:
+			case GreaterEqual:
+			{
+				double bound = op == Greater ? std::floor(value) + 1 : std::ceil(value);
+				if(bound <= lowest)
+				{
+					predicate.m_kernel = &MatchAll;
+				}
+				else if(bound > highest)
+				{
+					predicate.m_kernel = &MatchNone;
+				}
+				else
+				{
+					StoreValue<T>(predicate, GreaterEqual, (T)bound);
+				}
+				return;
+			}
+			}
+			throw std::invalid_argument("Query::Where(), unknown CompareOp");
+		}
+
+		// Float members: a value with no exact float becomes the nearest float bound on the matching side.
+		// Infinite and NaN values keep their meaning; finite values beyond the float range round to FLT_MAX first.
+		void StoreFloatBound(Query::Predicate& predicate, CompareOp op, double value)
+		{
+			const double highest = (double)std::numeric_limits<float>::max();
+			float rounded = std::isinf(value) || std::isnan(value) ? (float)value : (float)std::max(-highest, std::min(highest, value));
+			if(std::isnan(value) || (double)rounded == value)
+			{
+				StoreValue<float>(predicate, op, rounded);
+				return;
+			}
+
+			float below = (double)rounded > value ? std::nextafter(rounded, -std::numeric_limits<float>::infinity()) : rounded;
+			float above = (double)rounded < value ? std::nextafter(rounded, std::numeric_limits<float>::infinity()) : rounded;
+			switch(op)
+			{
+			case Equals:       predicate.m_kernel = &MatchNone; return;
+			case NotEquals:    predicate.m_kernel = &MatchAll; return;
+			case Less:
+			case LessEqual:    StoreValue<float>(predicate, LessEqual, below); return;
+			case Greater:
+			case GreaterEqual: StoreValue<float>(predicate, GreaterEqual, above); return;
+			}
+			throw std::invalid_argument("Query::Where(), unknown CompareOp");
+		}
+	}
+
+	Query::Query(const TypeData* type, const void* objects, size_t stride, size_t count) :
+		m_type(type),
+		m_objects(static_cast<const unsigned char*>(objects)),
+		m_stride(stride),
+		m_count(count)
+	{}
+
+	const Member* Query::FindMember(const char* member) const
+	{
+		const Member* found = m_type->GetMember(member);
+		if(!found)
+		{
+			throw std::invalid_argument("Query, no member with this name");
+		}
+		return found;
+	}
+
+	Query& Query::AddPredicate(const char* member, CompareOp op, double value)
+	{
+		const Member* compared = FindMember(member);
+		const TypeData* type = compared->GetStorageType();
+
+		Predicate predicate;
+		predicate.m_offset = compared->GetOffset();
+
+		if(type == Get<int>())
+		{
+			StoreIntegerBound<int>(predicate, op, value);
+		}
+		else if(type == Get<char>())
+		{
+			StoreIntegerBound<char>(predicate, op, value);
+		}
+		else if(type == Get<float>())
+		{
+			StoreFloatBound(predicate, op, value);
+		}
+		else if(type == Get<double>())
+		{
+			StoreValue<double>(predicate, op, value);
+		}
+		else
+		{
+			throw std::invalid_argument("Query::Where(), member type can't be compared");
+		}
+
+		m_predicates.push_back(predicate);
+		return *this;
+	}
+
+	std::vector<uint64_t> Query::Mask() const
+	{
+		size_t words = (m_count + 63) / 64;
+		std::vector<uint64_t> mask(words);
+
+		for(size_t word = 0; word < words; ++word)
+		{
+			size_t first = word * 64;
+			size_t count = std::min<size_t>(64, m_count - first);
+
+			uint64_t bits = count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+			for(const Predicate& predicate : m_predicates)
+			{
+				if(!bits)
+				{
+					break;
+				}
+				bits &= predicate.m_kernel(m_objects + first * m_stride + predicate.m_offset, m_stride, count, predicate);
+			}
+			mask[word] = bits;
+		}
+		return mask;
+	}
+
+	std::vector<size_t> Query::Matches() const
+	{
+		std::vector<uint64_t> mask = Mask();
+
+		std::vector<size_t> rows;
+		for(size_t word = 0; word < mask.size(); ++word)
+		{
+			for(uint64_t bits = mask[word]; bits; bits &= bits - 1)
+			{
+				rows.push_back(word * 64 + CountTrailingZeros(bits));
+			}
+		}
+		return rows;
+	}
+
+	size_t Query::Count() const
+	{
+		size_t count = 0;
+		for(uint64_t bits : Mask())
+		{
+			count += PopCount(bits);
+		}
+		return count;
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+// Filters arrays of reflected objects by member values:
+//     meta::Query(objects).Where("a", meta::Greater, 5).Where("b", meta::Less, 2.0f).Select<float>("b")
+// Member names are resolved once, in Where(). Each predicate becomes a typed kernel that gathers 64 rows of its
+// column and compares them into a bitmask without branches.
+// Members of type int, char, float and double can be compared. The value is compared as the number it is, not as it
+// would be after a cast to the member's type: Where("id", Less, 5.5) keeps id 5, Where("id", Equals, 5.5) keeps
+// nothing, and Where("tier", Less, 300) on a char keeps every row. Values go through double, so integer values
+// beyond 2^53 are rounded.
+
+#include "MetaColumn.h"
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace meta
+{
+	enum CompareOp
+	{
+		Equals,
+		NotEquals,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual
+	};
+
+	class Query
+	{
+	public:
+		Query(const TypeData* type, const void* objects, size_t stride, size_t count);
+
+		template <typename Object>
+		Query(const Object* objects, size_t count) : Query(Get<Object>(), objects, sizeof(Object), count) {}
+
+		template <typename Object>
+		Query(const std::vector<Object>& objects) : Query(objects.data(), objects.size()) {}
+
+		// Keeps rows where (member op value). Throws std::invalid_argument for unknown or uncomparable members.
+		template <typename V>
+		Query& Where(const char* member, CompareOp op, V value)
+		{
+			static_assert(std::is_arithmetic<V>::value, "Query::Where(), compare against a number.");
+			return AddPredicate(member, op, (double)value);
+		}
+
+		// Bit i of word i / 64 is set if row i matches every predicate.
+		std::vector<uint64_t> Mask() const;
+
+		std::vector<size_t> Matches() const;
+		size_t Count() const;
+
+		// Copies a member of every matching row.
+		template <typename T>
+		std::vector<T> Select(const char* member) const
+		{
+			const Member* selected = FindMember(member);
+			if(selected->GetStorageType() != Get<T>())
+			{
+				throw std::invalid_argument("Query::Select(), member is not a T");
+			}
+
+			std::vector<T> values;
+			for(size_t row : Matches())
+			{
+				values.push_back(*static_cast<const T*>(selected->GetPointer(m_objects + row * m_stride)));
+			}
+			return values;
+		}
+
+		struct Predicate
+		{
+			// Compares count (up to 64) rows starting at column, returns the bitmask of matches.
+			uint64_t (*m_kernel)(const unsigned char* column, size_t stride, size_t count, const Predicate& predicate);
+			size_t m_offset;
+			unsigned char m_value[8];	// the compared value, converted to the member's type
+		};
+
+	private:
+		Query& AddPredicate(const char* member, CompareOp op, double value);
+		const Member* FindMember(const char* member) const;
+
+		const TypeData* m_type;
+		const unsigned char* m_objects;
+		size_t m_stride;
+		size_t m_count;
+		std::vector<Predicate> m_predicates;
+	};
+}
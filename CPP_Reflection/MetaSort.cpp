@@ -0,0 +1,233 @@
+#include "MetaSort.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+
+namespace meta
+{
+	namespace
+	{
+		struct AlignedDelete
+		{
+			std::align_val_t m_alignment;
+			void operator()(unsigned char* buffer) const { ::operator delete(buffer, m_alignment); }
+		};
+
+		// For relocations made while unwinding from a throwing one: a second throw calls std::terminate() instead of
+		// leaving holes in the array.
+		void RelocateOrTerminate(const TypeData* type, void* at, void* source, size_t count) noexcept
+		{
+			type->RelocateArray(at, source, count);
+		}
+
+		template <typename K>
+		struct KeyIndex
+		{
+			K m_key;
+			uint32_t m_index;
+		};
+
+		// Maps values to unsigned keys with the same order.
+		inline uint32_t EncodeKey(int value)   { return (uint32_t)value ^ 0x80000000u; }
+		inline uint32_t EncodeKey(char value)  { return (uint32_t)(unsigned char)value ^ (std::numeric_limits<char>::is_signed ? 0x80u : 0u); }
+
+		inline uint32_t EncodeKey(float value)
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+		}
+
+		inline uint64_t EncodeKey(double value)
+		{
+			uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return (bits & 0x8000000000000000ull) ? ~bits : bits | 0x8000000000000000ull;
+		}
+
+		template <typename T, typename K>
+		void ExtractKeys(const unsigned char* column, size_t stride, size_t count, SortOrder order, KeyIndex<K>* out)
+		{
+			// Descending flips the keys, so equal keys still keep their order.
+			K flip = order == Descending ? ~K(0) : K(0);
+			for(size_t i = 0; i < count; ++i)
+			{
+				T value;
+				std::memcpy(&value, column + i * stride, sizeof(T));
+				out[i].m_key = (K)EncodeKey(value) ^ flip;
+				out[i].m_index = (uint32_t)i;
+			}
+		}
+
+		// LSD radix sort, a byte per pass. Passes where every key has the same byte are skipped.
+		template <typename K>
+		void RadixSort(std::vector<KeyIndex<K>>& items)
+		{
+			const unsigned int passes = sizeof(K);
+			size_t count = items.size();
+
+			std::vector<size_t> histograms(passes * 256, 0);
+			for(const KeyIndex<K>& item : items)
+			{
+				for(unsigned int pass = 0; pass < passes; ++pass)
+				{
+					++histograms[pass * 256 + ((item.m_key >> (pass * 8)) & 0xFF)];
+				}
+			}
+
+			std::vector<KeyIndex<K>> scratch(count);
+			for(unsigned int pass = 0; pass < passes; ++pass)
+			{
+				size_t* histogram = &histograms[pass * 256];
+				if(histogram[(items[0].m_key >> (pass * 8)) & 0xFF] == count)
+				{
+					continue;
+				}
+
+				size_t offset = 0;
+				for(unsigned int bucket = 0; bucket < 256; ++bucket)
+				{
+					size_t bucketCount = histogram[bucket];
+					histogram[bucket] = offset;
+					offset += bucketCount;
+				}
+
+				for(const KeyIndex<K>& item : items)
+				{
+					scratch[histogram[(item.m_key >> (pass * 8)) & 0xFF]++] = item;
+				}
+				items.swap(scratch);
+			}
+		}
+
+		template <typename T, typename K>
+		std::vector<uint32_t> RadixOrder(const unsigned char* column, size_t stride, size_t count, SortOrder order)
+		{
+			std::vector<KeyIndex<K>> items(count);
+			ExtractKeys<T>(column, stride, count, order, items.data());
+			RadixSort(items);
+
+			std::vector<uint32_t> permutation(count);
+			for(size_t i = 0; i < count; ++i)
+			{
+				permutation[i] = items[i].m_index;
+			}
+			return permutation;
+		}
+	}
+
+	std::vector<uint32_t> SortedOrder(const TypeData* type, const void* objects, size_t count, const Member* member, SortOrder order)
+	{
+		if(count > std::numeric_limits<uint32_t>::max())
+		{
+			throw std::length_error("meta::SortBy(), too many objects");
+		}
+		if(count == 0)
+		{
+			return std::vector<uint32_t>();
+		}
+
+		const unsigned char* column = static_cast<const unsigned char*>(objects) + member->GetOffset();
+		size_t stride = type->GetSize();
+		const TypeData* memberType = member->GetStorageType();
+
+		if(memberType == Get<int>())
+		{
+			return RadixOrder<int, uint32_t>(column, stride, count, order);
+		}
+		if(memberType == Get<char>())
+		{
+			return RadixOrder<char, uint32_t>(column, stride, count, order);
+		}
+		if(memberType == Get<float>())
+		{
+			return RadixOrder<float, uint32_t>(column, stride, count, order);
+		}
+		if(memberType == Get<double>())
+		{
+			return RadixOrder<double, uint64_t>(column, stride, count, order);
+		}
+
+		bool (*less)(const void*, const void*) = memberType->GetLifecycle().m_less;
+		if(!less)
+		{
+			throw std::invalid_argument("meta::SortBy(), member type has no operator<");
+		}
+
+		std::vector<uint32_t> permutation(count);
+		for(size_t i = 0; i < count; ++i)
+		{
+			permutation[i] = (uint32_t)i;
+		}
+
+		std::stable_sort(permutation.begin(), permutation.end(), [&](uint32_t a, uint32_t b)
+		{
+			const void* left = column + a * stride;
+			const void* right = column + b * stride;
+			return order == Ascending ? less(left, right) : less(right, left);
+		});
+		return permutation;
+	}
+
+	void SortBy(const TypeData* type, void* objects, size_t count, const Member* member, SortOrder order)
+	{
+		bool trivial = (type->GetFlags() & TypeLifecycle::F_TriviallyCopyable) != 0;
+		if(!trivial && !type->GetLifecycle().m_relocateArray)
+		{
+			throw std::logic_error("meta::SortBy(), type is not move constructible");
+		}
+
+		std::vector<uint32_t> permutation = SortedOrder(type, objects, count, member, order);
+
+		// Relocate every object once into sorted order, then back.
+		size_t size = type->GetSize();
+		unsigned char* base = static_cast<unsigned char*>(objects);
+		std::align_val_t alignment = std::align_val_t(type->GetAlignment());
+		std::unique_ptr<unsigned char[], AlignedDelete> sorted(static_cast<unsigned char*>(::operator new(size * count, alignment)), AlignedDelete{ alignment });
+
+		if(trivial)
+		{
+			for(size_t i = 0; i < count; ++i)
+			{
+				std::memcpy(sorted.get() + i * size, base + permutation[i] * size, size);
+			}
+			std::memcpy(base, sorted.get(), size * count);
+			return;
+		}
+
+		// One object at a time, so a relocation that throws leaves every other object whole, on one side or the other.
+		// Out of base, the moved ones go back to their slots; back into base, the rest follow in sorted order.
+		size_t moved = 0;
+		try
+		{
+			for(; moved < count; ++moved)
+			{
+				type->RelocateArray(sorted.get() + moved * size, base + permutation[moved] * size, 1);
+			}
+		}
+		catch(...)
+		{
+			for(size_t i = 0; i < moved; ++i)
+			{
+				RelocateOrTerminate(type, base + permutation[i] * size, sorted.get() + i * size, 1);
+			}
+			throw;
+		}
+
+		size_t placed = 0;
+		try
+		{
+			for(; placed < count; ++placed)
+			{
+				type->RelocateArray(base + placed * size, sorted.get() + placed * size, 1);
+			}
+		}
+		catch(...)
+		{
+			RelocateOrTerminate(type, base + placed * size, sorted.get() + placed * size, count - placed);
+			throw;
+		}
+	}
+}
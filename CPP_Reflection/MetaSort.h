@@ -0,0 +1,39 @@
+#pragma once
+
+// Sorts arrays of reflected objects by a member chosen at runtime.
+// Keys are extracted once into a contiguous key/index buffer, sorted there, and the objects are permuted once.
+// int, char, float and double members take an LSD radix sort; other members fall back to a comparison sort
+// with the member type's operator<. The sort is stable, in both orders.
+
+#include "Meta.h"
+#include <vector>
+
+namespace meta
+{
+	enum SortOrder
+	{
+		Ascending,
+		Descending
+	};
+
+	// objects is an array of count objects of type. Throws std::invalid_argument if the member can't be ordered, and
+	// std::logic_error if type can't be relocated. If relocating an object throws, the exception is rethrown with every
+	// object in the array, in its original order or, if it threw while moving them back, sorted. A second throw while
+	// recovering calls std::terminate().
+	void SortBy(const TypeData* type, void* objects, size_t count, const Member* member, SortOrder order = Ascending);
+
+	// The permutation SortBy() would apply: element i of the result is the index of the object that sorts to i.
+	std::vector<uint32_t> SortedOrder(const TypeData* type, const void* objects, size_t count, const Member* member, SortOrder order = Ascending);
+
+	template <typename Object>
+	void SortBy(Object* objects, size_t count, const Member* member, SortOrder order = Ascending)
+	{
+		SortBy(Get<Object>(), objects, count, member, order);
+	}
+
+	template <typename Object>
+	void SortBy(std::vector<Object>& objects, const Member* member, SortOrder order = Ascending)
+	{
+		SortBy(Get<Object>(), objects.data(), objects.size(), member, order);
+	}
+}
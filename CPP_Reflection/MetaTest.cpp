@@ -5,7 +5,11 @@
 #include "MacroHelpers.h"
 #include "AnyTest.h"
 #include "Indices.h"
+#include <memory>
+#include <string>
 
+meta_declare_primitive(std::string);
+meta_declare_primitive(std::unique_ptr<int>);
 
 namespace MetaTest
 {
@@ -49,6 +53,96 @@ namespace MetaTest
 		.finish();
 
 
+	namespace Other
+	{
+		// same short name as MetaTest::A1
+		class A1
+		{
+			double d;
+
+		public:
+			meta_declare(A1);
+		};
+
+		meta_define(A1)
+			.member("d", &A1::d)
+			.finish();
+	}
+
+	static_assert(meta::internal::TypeName<MetaTest::Other::A1>::view == "MetaTest::Other::A1", "TypeName should be fully qualified.");
+	static_assert(meta::internal::TypeName<MetaTest::Other::A1>::hash != meta::internal::TypeName<MetaTest::A1>::hash, "TypeName hash collided.");
+
+	// a test class for forwarding calls
+	class B1
+	{
+		int m_value;
+
+	public:
+		const std::string* m_peeked;
+
+		B1() : m_value(0), m_peeked(nullptr) {}
+
+		int take(std::unique_ptr<int>&& p) { m_value = *p; return m_value; }
+		int consume(std::string s) { std::string kept(std::move(s)); return (int)kept.size(); }
+		int peek(const std::string& s) { m_peeked = &s; return (int)s.size(); }
+		int get() const noexcept { return m_value; }
+		int release() && { int v = m_value; m_value = 0; return v; }
+		static int twice(int x) { return x * 2; }
+
+		meta_declare(B1);
+	};
+
+	meta_define(B1)
+		.method("take", &B1::take)
+		.method("consume", &B1::consume)
+		.method("peek", &B1::peek)
+		.method("get", &B1::get)
+		.method("release", &B1::release)
+		.method("twice", &B1::twice)
+		.method("add", [](int x, int y) { return x + y; })
+		.finish();
+
+	void ForwardingTest()
+	{
+		B1 b;
+		const meta::TypeData* bInfo = meta::Get<B1>();
+
+		//move-only argument, bound to T&&
+		Any taken = meta::Invoke(bInfo->GetMethod("take"), b, std::unique_ptr<int>(new int(7)));
+		assert(taken.cast<int>() == 7);
+
+		//noexcept const method, called on the object itself (not a copy)
+		const B1& constB = b;
+		assert(meta::Invoke(bInfo->GetMethod("get"), constB).cast<int>() == 7);
+
+		//by-value argument, moved in
+		std::string text("move me, don't copy me");
+		assert(meta::Invoke(bInfo->GetMethod("consume"), b, std::move(text)).cast<int>() == 22);
+
+		//shared argument bound to const T&, read in place rather than copied out
+		Any payload(std::string(1000, 'x'));
+		payload.share();
+		Any obj(&b);
+		Any argV[1] = { payload };
+		for(int i = 0; i < 2; ++i)
+		{
+			assert(bInfo->GetMethod("peek")->DoCall(obj, argV).cast<int>() == 1000);
+			assert(argV[0].shared() && b.m_peeked == &static_cast<const Any&>(payload).cast<std::string>());
+		}
+
+		//rvalue-qualified method
+		assert(meta::Invoke(bInfo->GetMethod("release"), b).cast<int>() == 7);
+		assert(b.get() == 0);
+
+		//free function and lambda, registered as static methods
+		assert(meta::Invoke(bInfo->GetMethod("twice"), b, 21).cast<int>() == 42);
+		assert(meta::Invoke(bInfo->GetMethod("add"), b, 40, 2).cast<int>() == 42);
+		assert(bInfo->GetMethod("add")->GetArity() == 2);
+		assert(bInfo->GetMethod("take")->GetParamType(0).m_type == meta::Get<std::unique_ptr<int>>());
+
+		std::cout << "Forwarding calls: ok" << std::endl;
+	}
+
 	void Test1()
 	{
 		meta::has_getType_function<A1>::value ;
@@ -74,6 +168,13 @@ namespace MetaTest
 		}
 
 
+		//check signature tables
+		const meta::Method* bar = aInfo->GetMethod("bar");
+		assert(bar->GetParamTypes()[0].m_type == meta::Get<float>());
+		assert(bar->GetParamType(0).m_qualifier == meta::TypeRecord::Q_Value);
+		assert(bar->GetReturnType().m_type == meta::Get<int>());
+		assert(aInfo->GetMethod("foo")->GetReturnType().m_qualifier == meta::TypeRecord::Q_Void);
+
 		//check A1 members
 		for(unsigned int i = 0; i < aInfo->GetMembers().size(); ++i)
 		{
@@ -106,8 +207,22 @@ namespace MetaTest
 		std::cout << "Ran A1::bar() with argument " << 4.0f << ". Result should be " << expected << ". Result is: " << resultValue << std::endl;
 
 		//Retrieve via name
-		const meta::TypeData* aInfoAgain = meta::Get_Name("A1");
-		std::cout << "Retrieved type via name. Tried to get A1" << "; recieved " << aInfoAgain->GetNameStr() << std::endl;
+		const meta::TypeData* aInfoAgain = meta::Get_Name("MetaTest::A1");
+		std::cout << "Retrieved type via name. Tried to get MetaTest::A1" << "; recieved " << aInfoAgain->GetNameStr() << std::endl;
+		assert(aInfoAgain == aInfo);
+
+		//Same short name in another namespace doesn't collide
+		assert(meta::Get_Name("MetaTest::Other::A1") == meta::Get<Other::A1>());
+		assert(meta::Get_Name("MetaTest::Other::A1") != aInfo);
+		assert(meta::Get_Name("int") == meta::Get<int>());
+		assert(meta::Get_Name(std::string("MetaTest::A1")) == aInfo);
+
+		//Standard spellings of library types resolve to the compiler's name
+		assert(meta::Get_Name("std::string") == meta::Get<std::string>());
+		assert(meta::Get_Name(meta::Get<std::string>()->GetName()) == meta::Get<std::string>());
+		bool unknown = false;
+		try { meta::Get_Name("MetaTest::NoSuchType"); } catch(const std::out_of_range&) { unknown = true; }
+		assert(unknown);
 
 	}
 }
\ No newline at end of file
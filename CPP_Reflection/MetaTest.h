@@ -3,4 +3,5 @@
 namespace MetaTest
 {
 	void Test1();
+	void ForwardingTest();
 }
\ No newline at end of file
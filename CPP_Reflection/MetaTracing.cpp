@@ -0,0 +1,405 @@
+#include "MetaTracing.h"
+#include "Meta.h"
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace meta
+{
+	namespace tracing
+	{
+		namespace internal
+		{
+			std::atomic<bool> g_enabled(false);
+			std::atomic<bool> g_recordArguments(false);
+
+			static const char c_magic[4] = { 'M', 'T', 'R', 'C' };
+			static const uint32_t c_version = 1;
+
+			static std::mutex& RegistryMutex()
+			{
+				static std::mutex s_mutex;
+				return s_mutex;
+			}
+
+			// ThreadTraces outlive their threads, so a dump still sees their calls.
+			static std::vector<ThreadTrace*>& ThreadRegistry()
+			{
+				static std::vector<ThreadTrace*> s_threads;
+				return s_threads;
+			}
+
+			ThreadTrace* AttachThread()
+			{
+				if(t_threadTrace)
+				{
+					return t_threadTrace;
+				}
+
+				ThreadTrace* trace = new ThreadTrace();
+				trace->m_written.store(0, std::memory_order_relaxed);
+				for(TraceEvent& event : trace->m_events)
+				{
+					event.m_sequence.store(0, std::memory_order_relaxed);
+				}
+
+				std::lock_guard<std::mutex> lock(RegistryMutex());
+				trace->m_threadId = (uint32_t)ThreadRegistry().size();
+				ThreadRegistry().push_back(trace);
+				t_threadTrace = trace;
+				return trace;
+			}
+
+			uint8_t CaptureArguments(const Method* method, Any* argv, uint8_t* out)
+			{
+				unsigned int used = 0;
+				for(int i = 0; i < method->GetArity(); ++i)
+				{
+					size_t size = argv[i].isTriviallyCopyable() ? argv[i].getSize() : 0;
+					if(used + 1 + size > c_traceArgBytes || size > 0xFF)
+					{
+						break;
+					}
+
+					out[used++] = (uint8_t)size;
+					std::memcpy(out + used, static_cast<const Any&>(argv[i]).getRawPointer(), size);
+					used += (unsigned int)size;
+				}
+				return (uint8_t)used;
+			}
+
+			/*****/ //  Binary format  //
+			// "MTRC", version, ns per tick, then the method table, then the events. Native byte order.
+
+			template <typename T> void Write(std::ostream& out, const T& value)
+			{
+				out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+			}
+
+			static void WriteString(std::ostream& out, const std::string& str)
+			{
+				Write(out, (uint32_t)str.size());
+				out.write(str.data(), str.size());
+			}
+
+			template <typename T> bool Read(std::istream& in, T& value)
+			{
+				return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+			}
+
+			static bool ReadString(std::istream& in, std::string& str)
+			{
+				uint32_t size;
+				if(!Read(in, size))
+				{
+					return false;
+				}
+				str.resize(size);
+				return size == 0 || (bool)in.read(&str[0], size);
+			}
+
+			struct EventCopy
+			{
+				const Method* m_method;
+				uint32_t m_methodId;	// Index into the method table, once read back from a file.
+				uint32_t m_threadId;
+				uint64_t m_startTicks;
+				uint64_t m_durationTicks;
+				uint8_t m_argBytes;
+				uint8_t m_args[c_traceArgBytes];
+			};
+
+			// Copies out every complete event. A slot rewritten during the copy fails its sequence check and is skipped.
+			static std::vector<EventCopy> Snapshot()
+			{
+				std::vector<EventCopy> events;
+
+				std::lock_guard<std::mutex> lock(RegistryMutex());
+				for(ThreadTrace* trace : ThreadRegistry())
+				{
+					uint64_t written = trace->m_written.load(std::memory_order_acquire);
+					uint64_t first = written > c_traceBufferEvents ? written - c_traceBufferEvents + 1 : 1;
+
+					for(uint64_t number = first; number <= written; ++number)
+					{
+						TraceEvent& event = trace->m_events[(number - 1) % c_traceBufferEvents];
+						if(event.m_sequence.load(std::memory_order_acquire) != number)
+						{
+							continue;
+						}
+
+						EventCopy copy;
+						copy.m_method = event.m_method;
+						copy.m_methodId = 0;
+						copy.m_threadId = trace->m_threadId;
+						copy.m_startTicks = event.m_startTicks;
+						copy.m_durationTicks = event.m_durationTicks;
+						copy.m_argBytes = event.m_argBytes < c_traceArgBytes ? event.m_argBytes : (uint8_t)c_traceArgBytes;
+						std::memcpy(copy.m_args, event.m_args, copy.m_argBytes);
+
+						std::atomic_thread_fence(std::memory_order_acquire);
+						if(event.m_sequence.load(std::memory_order_relaxed) == number)
+						{
+							events.push_back(copy);
+						}
+					}
+				}
+
+				return events;
+			}
+
+			/*****/ //  Chrome trace conversion  //
+
+			struct MethodEntry
+			{
+				std::string m_name;
+				std::vector<uint8_t> m_paramQualifiers;
+				std::vector<std::string> m_paramTypes;
+			};
+
+			static void WriteJsonString(std::ostream& out, const std::string& str)
+			{
+				out << '"';
+				for(char c : str)
+				{
+					if(c == '"' || c == '\\')
+					{
+						out << '\\' << c;
+					}
+					else if((unsigned char)c < 0x20)
+					{
+						out << ' ';
+					}
+					else
+					{
+						out << c;
+					}
+				}
+				out << '"';
+			}
+
+			template <typename T> bool FormatAs(std::ostream& out, const uint8_t* bytes, uint8_t size)
+			{
+				if(size != sizeof(T))
+				{
+					return false;
+				}
+
+				T value;
+				std::memcpy(&value, bytes, sizeof(T));
+				out << +value;
+				return true;
+			}
+
+			// Known primitives print as values; everything else (pointers included) as hex bytes.
+			static void FormatArgument(std::ostream& out, uint8_t qualifier, const std::string& type, const uint8_t* bytes, uint8_t size)
+			{
+				if(!size)
+				{
+					WriteJsonString(out, "(not recorded)");
+					return;
+				}
+
+				bool isValue = qualifier == TypeRecord::Q_Value || qualifier == TypeRecord::Q_Reference || qualifier == TypeRecord::Q_ConstReference;
+				std::ostringstream str;
+				if(isValue && 
+					((type == "int" && FormatAs<int>(str, bytes, size)) ||
+					(type == "float" && FormatAs<float>(str, bytes, size)) ||
+					(type == "double" && FormatAs<double>(str, bytes, size)) ||
+					(type == "char" && FormatAs<char>(str, bytes, size))))
+				{
+					WriteJsonString(out, str.str());
+					return;
+				}
+
+				static const char c_hex[] = "0123456789abcdef";
+				str << "0x";
+				for(uint8_t i = 0; i < size; ++i)
+				{
+					str << c_hex[bytes[i] >> 4] << c_hex[bytes[i] & 0xF];
+				}
+				WriteJsonString(out, str.str());
+			}
+		}
+
+		void SetEnabled(bool enabled)
+		{
+			if(enabled)
+			{
+				instrumentation::internal::CalibrateNsPerTick();
+			}
+			internal::g_enabled.store(enabled, std::memory_order_release);
+		}
+
+		bool IsEnabled()
+		{
+			return internal::g_enabled.load(std::memory_order_relaxed);
+		}
+
+		void SetRecordArguments(bool record)
+		{
+			internal::g_recordArguments.store(record, std::memory_order_relaxed);
+		}
+
+		void AttachThread()
+		{
+			internal::AttachThread();
+		}
+
+		void DumpBinary(std::ostream& out)
+		{
+			using namespace internal;
+
+			std::vector<EventCopy> events = Snapshot();
+
+			std::unordered_map<const Method*, uint32_t> methodIds;
+			std::vector<const Method*> methods;
+			for(const EventCopy& event : events)
+			{
+				if(methodIds.emplace(event.m_method, (uint32_t)methods.size()).second)
+				{
+					methods.push_back(event.m_method);
+				}
+			}
+
+			out.write(c_magic, sizeof(c_magic));
+			Write(out, c_version);
+			Write(out, instrumentation::internal::CalibrateNsPerTick());
+
+			Write(out, (uint32_t)methods.size());
+			for(const Method* method : methods)
+			{
+				const TypeData* owner = method->GetOwner();
+				WriteString(out, (owner ? owner->GetNameStr() + "::" : std::string()) + method->GetNameStr());
+
+				Write(out, (uint32_t)method->GetArity());
+				for(int i = 0; i < method->GetArity(); ++i)
+				{
+					const TypeRecord& param = method->GetParamTypes()[i];
+					Write(out, (uint8_t)param.m_qualifier);
+					WriteString(out, param.m_type ? param.m_type->GetNameStr() : std::string());
+				}
+			}
+
+			Write(out, (uint64_t)events.size());
+			for(const EventCopy& event : events)
+			{
+				Write(out, methodIds[event.m_method]);
+				Write(out, event.m_threadId);
+				Write(out, event.m_startTicks);
+				Write(out, event.m_durationTicks);
+				Write(out, event.m_argBytes);
+				out.write(reinterpret_cast<const char*>(event.m_args), event.m_argBytes);
+			}
+		}
+
+		void DumpChromeTrace(std::ostream& out)
+		{
+			std::stringstream binary;
+			DumpBinary(binary);
+			ConvertBinaryToChromeTrace(binary, out);
+		}
+
+		bool ConvertBinaryToChromeTrace(std::istream& in, std::ostream& out)
+		{
+			using namespace internal;
+
+			char magic[4];
+			uint32_t version;
+			double nsPerTick;
+			if(!in.read(magic, sizeof(magic)) || std::memcmp(magic, c_magic, sizeof(magic)) != 0 ||
+				!Read(in, version) || version != c_version || !Read(in, nsPerTick))
+			{
+				return false;
+			}
+
+			uint32_t methodCount;
+			if(!Read(in, methodCount))
+			{
+				return false;
+			}
+
+			std::vector<MethodEntry> methods(methodCount);
+			for(MethodEntry& method : methods)
+			{
+				uint32_t arity;
+				if(!ReadString(in, method.m_name) || !Read(in, arity))
+				{
+					return false;
+				}
+
+				method.m_paramQualifiers.resize(arity);
+				method.m_paramTypes.resize(arity);
+				for(uint32_t i = 0; i < arity; ++i)
+				{
+					if(!Read(in, method.m_paramQualifiers[i]) || !ReadString(in, method.m_paramTypes[i]))
+					{
+						return false;
+					}
+				}
+			}
+
+			uint64_t eventCount;
+			if(!Read(in, eventCount))
+			{
+				return false;
+			}
+
+			std::vector<EventCopy> events;
+			uint64_t firstTick = UINT64_MAX;
+			for(uint64_t e = 0; e < eventCount; ++e)
+			{
+				EventCopy event;
+				if(!Read(in, event.m_methodId) || event.m_methodId >= methodCount || !Read(in, event.m_threadId) || 
+					!Read(in, event.m_startTicks) || !Read(in, event.m_durationTicks) || 
+					!Read(in, event.m_argBytes) || event.m_argBytes > c_traceArgBytes ||
+					!in.read(reinterpret_cast<char*>(event.m_args), event.m_argBytes))
+				{
+					return false;
+				}
+
+				event.m_method = nullptr;
+				firstTick = event.m_startTicks < firstTick ? event.m_startTicks : firstTick;
+				events.push_back(event);
+			}
+
+			out << "{\"traceEvents\":[";
+			for(size_t e = 0; e < events.size(); ++e)
+			{
+				const EventCopy& event = events[e];
+				const MethodEntry& method = methods[event.m_methodId];
+
+				out << (e ? ",\n" : "\n") << "{\"name\":";
+				WriteJsonString(out, method.m_name);
+				out << ",\"cat\":\"meta\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.m_threadId
+					<< ",\"ts\":" << (event.m_startTicks - firstTick) * nsPerTick / 1000.0
+					<< ",\"dur\":" << event.m_durationTicks * nsPerTick / 1000.0;
+
+				if(event.m_argBytes)
+				{
+					out << ",\"args\":{";
+					unsigned int offset = 0;
+					for(size_t i = 0; i < method.m_paramTypes.size() && offset < event.m_argBytes; ++i)
+					{
+						uint8_t size = event.m_args[offset++];
+						if(offset + size > event.m_argBytes)
+						{
+							break;
+						}
+
+						out << (i ? "," : "") << "\"" << i << "\":";
+						FormatArgument(out, method.m_paramQualifiers[i], method.m_paramTypes[i], event.m_args + offset, size);
+						offset += size;
+					}
+					out << "}";
+				}
+				out << "}";
+			}
+			out << "\n]}" << std::endl;
+
+			return true;
+		}
+	}
+}
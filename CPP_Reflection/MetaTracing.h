@@ -0,0 +1,138 @@
+#pragma once
+
+// Records every reflected call (method, thread, timestamp, duration, and optionally argument bytes)
+// into per-thread ring buffers, for dumping as Chrome trace-event JSON or a compact binary file.
+// Compiled in with META_TRACING=1 (CMake option META_TRACING), then switched on with meta::tracing::SetEnabled(true).
+// Recording takes no locks and, after a thread's first traced call (or tracing::AttachThread()), does not allocate.
+// Each thread keeps its last c_traceBufferEvents calls.
+
+#ifndef META_TRACING
+#define META_TRACING 0
+#endif
+
+#ifndef META_TRACE_BUFFER_EVENTS
+#define META_TRACE_BUFFER_EVENTS 16384
+#endif
+
+#include "MetaInstrumentation.h"	// ReadTicks()
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+
+struct Any;
+
+namespace meta
+{
+	class Method;
+
+	namespace tracing
+	{
+		static const unsigned int c_traceBufferEvents = META_TRACE_BUFFER_EVENTS;
+		static const unsigned int c_traceArgBytes = 40;
+
+		void SetEnabled(bool enabled);
+		bool IsEnabled();
+
+		// Also record argument values: the raw bytes of each trivially copyable argument, up to c_traceArgBytes per call.
+		// Other arguments (strings, containers) own memory elsewhere, so their bytes mean nothing; they're shown as
+		// not recorded.
+		void SetRecordArguments(bool record);
+
+		// Allocates the calling thread's buffer up front, so its first traced call doesn't.
+		void AttachThread();
+
+		// Snapshots every thread's buffer. Calls still being written are skipped.
+		void DumpBinary(std::ostream& out);
+		void DumpChromeTrace(std::ostream& out);
+
+		// Converts a DumpBinary() file to Chrome trace-event JSON (chrome://tracing, Perfetto).
+		// Returns false if the input isn't a trace.
+		bool ConvertBinaryToChromeTrace(std::istream& in, std::ostream& out);
+
+		namespace internal
+		{
+			// Seqlock slot: m_sequence is 0 while being written, then the event's number.
+			struct TraceEvent
+			{
+				std::atomic<uint64_t> m_sequence;
+				const Method* m_method;
+				uint64_t m_startTicks;
+				uint64_t m_durationTicks;
+				uint8_t m_argBytes;
+				uint8_t m_args[c_traceArgBytes];
+			};
+
+			struct ThreadTrace
+			{
+				uint32_t m_threadId;
+				std::atomic<uint64_t> m_written;
+				TraceEvent m_events[c_traceBufferEvents];
+			};
+
+			extern std::atomic<bool> g_enabled;
+			extern std::atomic<bool> g_recordArguments;
+			inline thread_local ThreadTrace* t_threadTrace = nullptr;
+
+			ThreadTrace* AttachThread();
+
+			// Arguments are stored as [size][bytes] per argument, in order, until the buffer is full.
+			// Size 0 marks an argument that isn't trivially copyable, and wasn't recorded.
+			uint8_t CaptureArguments(const Method* method, Any* argv, uint8_t* out);
+
+			// Traces the enclosing call, if tracing is enabled.
+			class TraceScope
+			{
+				const Method* m_method;
+				uint64_t m_start;
+				uint8_t m_argBytes;
+				uint8_t m_args[c_traceArgBytes];
+
+			public:
+				TraceScope(const Method* method, Any* argv) : m_method(method), m_start(0), m_argBytes(0)
+				{
+					if(g_enabled.load(std::memory_order_acquire))
+					{
+						if(argv && g_recordArguments.load(std::memory_order_relaxed))
+						{
+							m_argBytes = CaptureArguments(method, argv, m_args);
+						}
+						m_start = instrumentation::internal::ReadTicks();
+					}
+				}
+
+				~TraceScope()
+				{
+					if(!m_start)
+					{
+						return;
+					}
+
+					uint64_t end = instrumentation::internal::ReadTicks();
+					ThreadTrace* trace = t_threadTrace ? t_threadTrace : AttachThread();
+
+					uint64_t number = trace->m_written.load(std::memory_order_relaxed) + 1;
+					TraceEvent& event = trace->m_events[(number - 1) % c_traceBufferEvents];
+
+					event.m_sequence.store(0, std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_release);
+
+					event.m_method = m_method;
+					event.m_startTicks = m_start;
+					event.m_durationTicks = end - m_start;
+					event.m_argBytes = m_argBytes;
+					std::memcpy(event.m_args, m_args, m_argBytes);
+
+					event.m_sequence.store(number, std::memory_order_release);
+					trace->m_written.store(number, std::memory_order_release);
+				}
+			};
+		}
+	}
+}
+
+#if META_TRACING
+	#define META_TRACE_CALL(method, argv) meta::tracing::internal::TraceScope metaTraceScope((method), (argv))
+#else
+	#define META_TRACE_CALL(method, argv)
+#endif
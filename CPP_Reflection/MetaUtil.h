@@ -1,3 +1,80 @@
 #pragma once
 
-const char* TrimTypeToName(const char* fullname);
\ No newline at end of file
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace meta
+{
+	namespace internal
+	{
+		/*****************************************************/
+		//                    Type Names                     //
+		/*****************************************************/
+
+		// FNV-1a. Usable at compile time, so registration never hashes strings at runtime.
+		constexpr uint64_t HashName(std::string_view name)
+		{
+			uint64_t hash = 14695981039346656037ull;
+			for(char c : name)
+			{
+				hash ^= static_cast<unsigned char>(c);
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		// The compiler's pretty signature of this function contains the fully qualified name of T.
+		template <typename T>
+		constexpr std::string_view FunctionSignature()
+		{
+		#if defined(_MSC_VER)
+			return __FUNCSIG__;
+		#else
+			return __PRETTY_FUNCTION__;
+		#endif
+		}
+
+		// Where T's name sits in FunctionSignature<T>(), found by probing with int.
+		// (rfind, because "meta::internal" contains "int".)
+		constexpr size_t c_signaturePrefix = FunctionSignature<int>().rfind("int");
+		constexpr size_t c_signatureSuffix = FunctionSignature<int>().size() - c_signaturePrefix - 3;
+
+		template <typename T>
+		constexpr std::string_view TypeNameView()
+		{
+			std::string_view name = FunctionSignature<T>();
+			name = name.substr(c_signaturePrefix, name.size() - c_signaturePrefix - c_signatureSuffix);
+
+			// MSVC spells out the elaborated type specifier.
+			for(std::string_view tag : { std::string_view("class "), std::string_view("struct "), std::string_view("enum ") })
+			{
+				if(name.substr(0, tag.size()) == tag)
+				{
+					name.remove_prefix(tag.size());
+				}
+			}
+			return name;
+		}
+
+		template <typename T, size_t... Is>
+		constexpr std::array<char, sizeof...(Is) + 1> NullTerminatedTypeName(std::index_sequence<Is...>)
+		{
+			constexpr std::string_view name = TypeNameView<T>();
+			return {{ name[Is]..., '\0' }};
+		}
+
+		// Fully qualified name of T (e.g. "MetaTest::A1"), and its hash, computed at compile time.
+		template <typename T>
+		struct TypeName
+		{
+			static constexpr std::string_view view = TypeNameView<T>();
+			static constexpr uint64_t hash = HashName(view);
+			static constexpr std::array<char, view.size() + 1> name = NullTerminatedTypeName<T>(std::make_index_sequence<view.size()>());
+
+			static constexpr const char* c_str() { return name.data(); }
+		};
+	}
+}
@@ -0,0 +1,118 @@
+#include "MigrationTest.h"
+#include "MetaMigration.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <assert.h>
+
+namespace MigrationTest
+{
+	struct Vec2
+	{
+		float x;
+		float y;
+	};
+
+	// As it was saved
+	struct PlayerV1
+	{
+		int id;
+		char level;
+		float speed;
+		Vec2 position;
+		int retired;
+	};
+
+	// As it is now: level widened, speed widened, fields reordered, retired removed, health added
+	class Player
+	{
+	public:
+		Vec2 position;
+		long long level;
+		int id;
+		double speed;
+		int health;
+		std::string name;	// not reflected
+
+		Player() : position{ 0.0f, 0.0f }, level(0), id(0), speed(0.0), health(100), name("unnamed") {}
+
+		meta_declare(Player);
+	};
+
+	meta_define(Player)
+		.member("position", &Player::position)
+		.member("level", &Player::level)
+		.member("id", &Player::id)
+		.member("speed", &Player::speed)
+		.member("health", &Player::health)
+		.finish();
+}
+
+meta_declare_primitive(MigrationTest::Vec2)
+	.member("x", &MigrationTest::Vec2::x)
+	.member("y", &MigrationTest::Vec2::y)
+	.finish();
+
+meta_declare_primitive(MigrationTest::PlayerV1)
+	.member("id", &MigrationTest::PlayerV1::id)
+	.member("level", &MigrationTest::PlayerV1::level)
+	.member("speed", &MigrationTest::PlayerV1::speed)
+	.member("position", &MigrationTest::PlayerV1::position)
+	.member("retired", &MigrationTest::PlayerV1::retired)
+	.finish();
+
+namespace MigrationTest
+{
+	void BasicTest()
+	{
+		meta::Schema current = meta::Schema::Of(meta::Get<Player>());
+		assert(current.GetFields().size() == 6 && current.GetFields()[0].m_name == "position.x");
+
+		// The schema goes through the save file
+		std::stringstream file;
+		meta::Schema::Of(meta::Get<PlayerV1>()).Write(file);
+		meta::Schema saved = meta::Schema::Read(file);
+		assert(saved == meta::Schema::Of(meta::Get<PlayerV1>()) && saved != current);
+
+		const meta::MigrationPlan& plan = meta::GetMigrationPlan(saved, meta::Get<Player>());
+		assert(&plan == &meta::GetMigrationPlan(saved, meta::Get<Player>()));
+		assert(plan.GetDefaulted() == (std::vector<std::string>{ "health" }));
+		assert(plan.GetDropped() == (std::vector<std::string>{ "retired" }));
+		assert(plan.GetSteps().size() == 4);	// position as one span, level, id, speed
+
+		std::vector<PlayerV1> records(1000);
+		for(size_t i = 0; i < records.size(); ++i)
+		{
+			records[i] = PlayerV1{ (int)i, (char)(i % 100), 1.5f * i, { (float)i, -(float)i }, 1 };
+		}
+
+		std::vector<Player> players(records.size());
+		meta::Get<Player>()->DestroyArray(players.data(), players.size());
+		meta::Migrate(saved, records.data(), records.size(), players.data());
+
+		for(size_t i = 0; i < players.size(); ++i)
+		{
+			const Player& player = players[i];
+			assert(player.id == (int)i && player.level == (long long)(i % 100) && player.speed == 1.5f * i);
+			assert(player.position.x == (float)i && player.position.y == -(float)i);
+			assert(player.health == 100 && player.name == "unnamed");
+		}
+
+		// Same layout: a straight copy
+		const meta::MigrationPlan& identity = meta::GetMigrationPlan(current, meta::Get<Player>());
+		assert(identity.GetDefaulted().empty() && identity.GetDropped().empty());
+
+		// Narrowing isn't a migration: speed and level are left at their defaults
+		const meta::MigrationPlan& backwards = meta::GetMigrationPlan(current, meta::Get<PlayerV1>());
+		assert(backwards.GetDefaulted() == (std::vector<std::string>{ "level", "speed", "retired" }));
+		assert(backwards.GetDropped() == (std::vector<std::string>{ "level", "speed", "health" }));
+
+		std::stringstream truncated(file.str().substr(0, 20));
+		bool threw = false;
+		try { meta::Schema::Read(truncated); } catch(const std::runtime_error&) { threw = true; }
+		assert(threw);
+
+		std::cout << "Migration: ok" << std::endl;
+	}
+}
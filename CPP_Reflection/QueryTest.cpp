@@ -0,0 +1,103 @@
+#include "QueryTest.h"
+#include "MetaQuery.h"
+#include <iostream>
+#include <assert.h>
+
+namespace QueryTest
+{
+	class Account
+	{
+	public:
+		int id;
+		char tier;
+		float balance;
+		double score;
+
+		meta_declare(Account);
+	};
+
+	meta_define(Account)
+		.member("id", &Account::id)
+		.member("tier", &Account::tier)
+		.member("balance", &Account::balance)
+		.member("score", &Account::score)
+		.finish();
+
+	void BasicTest()
+	{
+		// more than one 64 row word, with a partial last one
+		std::vector<Account> accounts(65536 + 1000);
+		for(size_t i = 0; i < accounts.size(); ++i)
+		{
+			accounts[i].id = (int)i;
+			accounts[i].tier = (char)('a' + i % 3);
+			accounts[i].balance = (float)(i % 100);
+			accounts[i].score = i * 0.5;
+		}
+
+		size_t expected = 0;
+		std::vector<float> expectedBalances;
+		for(const Account& account : accounts)
+		{
+			if(account.id > 5 && account.tier == 'b' && account.balance < 10.0f && account.score >= 100.0)
+			{
+				++expected;
+				expectedBalances.push_back(account.balance);
+			}
+		}
+
+		meta::Query query(accounts);
+		query.Where("id", meta::Greater, 5)
+			.Where("tier", meta::Equals, 'b')
+			.Where("balance", meta::Less, 10)
+			.Where("score", meta::GreaterEqual, 100.0);
+
+		assert(query.Count() == expected);
+		assert(meta::Query(accounts).Where("id", meta::LessEqual, 63).Count() == 64);
+		assert(meta::Query(accounts).Where("id", meta::NotEquals, 0).Count() == accounts.size() - 1);
+
+		std::vector<size_t> rows = query.Matches();
+		std::vector<float> balances = query.Select<float>("balance");
+		assert(rows.size() == expected && balances == expectedBalances);
+		assert(accounts[rows[0]].tier == 'b');
+
+		// small inputs, with a partial last block
+		std::vector<Account> few(accounts.begin(), accounts.begin() + 70);
+		assert(meta::Query(few).Where("id", meta::Greater, 65).Select<int>("id") == std::vector<int>({ 66, 67, 68, 69 }));
+
+		// values are compared as they are, not narrowed to the member's type
+		assert(meta::Query(few).Where("id", meta::Less, 5.5).Count() == 6);
+		assert(meta::Query(few).Where("id", meta::LessEqual, 5.5).Count() == 6);
+		assert(meta::Query(few).Where("id", meta::Greater, 65.5).Count() == 4);
+		assert(meta::Query(few).Where("id", meta::GreaterEqual, 65.5).Count() == 4);
+		assert(meta::Query(few).Where("id", meta::Less, -0.5).Count() == 0);
+		assert(meta::Query(few).Where("id", meta::Equals, 5.5).Count() == 0);
+		assert(meta::Query(few).Where("id", meta::NotEquals, 5.5).Count() == 70);
+		assert(meta::Query(few).Where("id", meta::Equals, 5.0).Count() == 1);
+		assert(meta::Query(few).Where("id", meta::Less, 1e300).Count() == 70);
+		assert(meta::Query(few).Where("id", meta::Greater, -1e300).Count() == 70);
+		assert(meta::Query(few).Where("id", meta::Greater, 5e9).Count() == 0);
+		assert(meta::Query(few).Where("id", meta::Less, 1ll << 40).Count() == 70);
+		assert(meta::Query(few).Where("tier", meta::Less, 300).Count() == 70);
+		assert(meta::Query(few).Where("tier", meta::Equals, 300 + 'a').Count() == 0);
+		assert(meta::Query(few).Where("tier", meta::GreaterEqual, -300).Count() == 70);
+		assert(meta::Query(few).Where("balance", meta::Less, 5.00000001).Count() == 6);
+		assert(meta::Query(few).Where("balance", meta::Greater, 4.99999999).Count() == 65);
+		assert(meta::Query(few).Where("balance", meta::Equals, 5.00000001).Count() == 0);
+		assert(meta::Query(few).Where("balance", meta::Less, 1e300).Count() == 70);
+		assert(meta::Query(few).Where("balance", meta::Greater, 1e300).Count() == 0);
+
+		bool threw = false;
+		try
+		{
+			meta::Query(few).Where("missing", meta::Equals, 1);
+		}
+		catch(const std::invalid_argument&)
+		{
+			threw = true;
+		}
+		assert(threw);
+
+		std::cout << "Query: ok" << std::endl;
+	}
+}
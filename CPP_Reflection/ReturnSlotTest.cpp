@@ -0,0 +1,113 @@
+#include "ReturnSlotTest.h"
+#include "Meta.h"
+#include <iostream>
+#include <new>
+#include <string>
+#include <assert.h>
+
+namespace ReturnSlotTest
+{
+	struct Matrix
+	{
+		float m[16];
+	};
+
+	// Counts how a result reaches its slot
+	struct Tracked
+	{
+		static int s_copies;
+		static int s_moves;
+
+		int value;
+
+		Tracked(int v) : value(v) {}
+		Tracked(const Tracked& rhs) : value(rhs.value) { ++s_copies; }
+		Tracked(Tracked&& rhs) : value(rhs.value) { ++s_moves; }
+		Tracked& operator=(const Tracked&) = default;
+	};
+
+	int Tracked::s_copies = 0;
+	int Tracked::s_moves = 0;
+}
+
+meta_declare_primitive(ReturnSlotTest::Matrix);
+meta_declare_primitive(ReturnSlotTest::Tracked);
+
+namespace ReturnSlotTest
+{
+	class Camera
+	{
+	public:
+		std::string name;
+		Matrix view;
+		uint64_t version;
+
+		Camera() : name("a camera with a name too long for the small string buffer"), version(meta::NextVersion())
+		{
+			for(int i = 0; i < 16; ++i)
+			{
+				view.m[i] = (float)i;
+			}
+		}
+
+		std::string GetName() const { return name; }
+		const std::string& GetNameRef() const { return name; }
+		Matrix GetView(float scale) const { Matrix result = view; result.m[5] *= scale; return result; }
+		Tracked Make(int value) const { return Tracked(value); }
+		void Touch() {}
+		uint64_t GetVersion() const { return version; }
+
+		meta_declare(Camera);
+	};
+
+	meta_define(Camera)
+		.method("GetName", &Camera::GetName)
+		.method("GetNameRef", &Camera::GetNameRef)
+		.method("GetView", &Camera::GetView)
+		.method("Make", &Camera::Make)
+		.pure_method("MakeCached", &Camera::Make)
+		.method("Touch", &Camera::Touch)
+		.finish();
+
+	void BasicTest()
+	{
+		const meta::TypeData* type = meta::Get<Camera>();
+		Camera camera;
+
+		alignas(std::string) unsigned char nameSlot[sizeof(std::string)];
+		std::string* name = reinterpret_cast<std::string*>(nameSlot);
+		meta::InvokeInto(name, type->GetMethod("GetName"), camera);
+		assert(*name == camera.name);
+		name->~basic_string();
+
+		// A reference result is copied into the slot
+		meta::InvokeInto(name, type->GetMethod("GetNameRef"), camera);
+		assert(*name == camera.name && name->data() != camera.name.data());
+		name->~basic_string();
+
+		// With a converted argument
+		Matrix view;
+		meta::InvokeInto(&view, type->GetMethod("GetView"), camera, 2);
+		assert(view.m[5] == 10.0f && view.m[15] == 15.0f);
+
+		// A prvalue is constructed in the slot: no copy, no move
+		alignas(Tracked) unsigned char trackedSlot[sizeof(Tracked)];
+		Tracked* tracked = reinterpret_cast<Tracked*>(trackedSlot);
+		meta::InvokeInto(tracked, type->GetMethod("Make"), camera, 7);
+		assert(tracked->value == 7 && Tracked::s_copies == 0 && Tracked::s_moves == 0);
+
+		// Memoized results come out of the cache
+		meta::InvokeInto(tracked, type->GetMethod("MakeCached"), camera, 8);
+		meta::InvokeInto(tracked, type->GetMethod("MakeCached"), camera, 8);
+		assert(tracked->value == 8);
+
+		// The wrong slot type is caught before the call
+		bool threw = false;
+		try { meta::InvokeInto(&view, type->GetMethod("GetName"), camera); } catch(const anyimpl::bad_any_cast&) { threw = true; }
+		assert(threw);
+
+		assert(type->GetMethod("Touch")->GetResultPolicy() == Any().getPolicy());
+
+		std::cout << "Return slot: ok" << std::endl;
+	}
+}
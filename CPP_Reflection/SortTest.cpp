@@ -0,0 +1,159 @@
+#include "SortTest.h"
+#include "MetaSort.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <assert.h>
+
+namespace SortTest
+{
+	struct Version
+	{
+		int major;
+		int minor;
+
+		bool operator<(const Version& rhs) const { return major != rhs.major ? major < rhs.major : minor < rhs.minor; }
+	};
+}
+
+meta_declare_primitive(SortTest::Version);
+
+namespace SortTest
+{
+	class Row
+	{
+	public:
+		int id;
+		float weight;
+		double score;
+		char grade;
+		Version version;
+		std::string label;	// not reflected, moved along with its row
+
+		meta_declare(Row);
+	};
+
+	meta_define(Row)
+		.member("id", &Row::id)
+		.member("weight", &Row::weight)
+		.member("score", &Row::score)
+		.member("grade", &Row::grade)
+		.member("version", &Row::version)
+		.finish();
+
+	// Its move constructor throws once s_movesLeft runs out.
+	class Fragile
+	{
+	public:
+		inline static int s_movesLeft = -1;
+
+		int id;
+		std::string label;
+
+		Fragile() : id(0) {}
+		Fragile(const Fragile&) = default;
+		Fragile& operator=(const Fragile&) = default;
+		Fragile(Fragile&& other) : id(other.id)
+		{
+			if(s_movesLeft-- == 0)
+			{
+				throw std::runtime_error("Fragile moved");
+			}
+			label = std::move(other.label);
+		}
+
+		meta_declare(Fragile);
+	};
+
+	meta_define(Fragile)
+		.member("id", &Fragile::id)
+		.finish();
+
+	template <typename T, typename Less>
+	static bool IsSorted(const std::vector<Row>& rows, T Row::*member, Less less)
+	{
+		for(size_t i = 1; i < rows.size(); ++i)
+		{
+			if(less(rows[i].*member, rows[i - 1].*member))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void BasicTest()
+	{
+		std::vector<Row> rows(1000);
+		for(size_t i = 0; i < rows.size(); ++i)
+		{
+			unsigned int hash = (unsigned int)(i * 2654435761u);
+			rows[i].id = (int)(hash % 2001) - 1000;
+			rows[i].weight = ((int)(hash % 301) - 150) * 0.25f;
+			rows[i].score = ((int)(hash % 7001) - 3500) * 1e-3;
+			rows[i].grade = (char)('A' + hash % 5);
+			rows[i].version = Version{ (int)(hash % 4), (int)(hash % 11) };
+			rows[i].label = std::to_string(rows[i].id);
+		}
+
+		const meta::TypeData* type = meta::Get<Row>();
+		auto less = [](auto a, auto b) { return a < b; };
+		auto greater = [](auto a, auto b) { return b < a; };
+
+		meta::SortBy(rows, type->GetMember("id"));
+		assert(IsSorted(rows, &Row::id, less) && rows[0].label == std::to_string(rows[0].id));
+
+		meta::SortBy(rows, type->GetMember("weight"), meta::Descending);
+		assert(IsSorted(rows, &Row::weight, greater));
+
+		meta::SortBy(rows, type->GetMember("score"));
+		assert(IsSorted(rows, &Row::score, less));
+
+		// stable: within a grade, rows stay ordered by score
+		meta::SortBy(rows, type->GetMember("grade"));
+		assert(IsSorted(rows, &Row::grade, less));
+		for(size_t i = 1; i < rows.size(); ++i)
+		{
+			assert(rows[i].grade != rows[i - 1].grade || !(rows[i].score < rows[i - 1].score));
+		}
+
+		// operator< fallback
+		meta::SortBy(rows, type->GetMember("version"), meta::Descending);
+		assert(IsSorted(rows, &Row::version, greater));
+
+		for(const Row& row : rows)
+		{
+			assert(row.label == std::to_string(row.id));
+		}
+
+		// A move that throws out of the array leaves it as it was, one that throws moving back leaves it sorted.
+		std::vector<Fragile> fragile(100);
+		for(size_t i = 0; i < fragile.size(); ++i)
+		{
+			fragile[i].id = (int)(fragile.size() - i);
+			fragile[i].label = std::to_string(fragile[i].id);
+		}
+		const meta::Member* fragileId = meta::Get<Fragile>()->GetMember("id");
+
+		Fragile::s_movesLeft = 40;
+		bool threw = false;
+		try { meta::SortBy(fragile, fragileId); } catch(const std::runtime_error&) { threw = true; }
+		assert(threw);
+		for(size_t i = 0; i < fragile.size(); ++i)
+		{
+			assert(fragile[i].id == (int)(fragile.size() - i) && fragile[i].label == std::to_string(fragile[i].id));
+		}
+
+		Fragile::s_movesLeft = 150;
+		threw = false;
+		try { meta::SortBy(fragile, fragileId); } catch(const std::runtime_error&) { threw = true; }
+		assert(threw);
+		for(size_t i = 0; i < fragile.size(); ++i)
+		{
+			assert(fragile[i].id == (int)(i + 1) && fragile[i].label == std::to_string(fragile[i].id));
+		}
+		Fragile::s_movesLeft = -1;
+
+		std::cout << "Sort: ok" << std::endl;
+	}
+}
@@ -0,0 +1,81 @@
+#include "TracingTest.h"
+#include "Meta.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <assert.h>
+#include <thread>
+
+namespace TracingTest
+{
+	class Scaler
+	{
+		int m_factor;
+
+	public:
+		Scaler() : m_factor(3) {}
+
+		int scale(int value) { return value * m_factor; }
+		int label(const std::string& prefix, int value) { return (int)prefix.size() + value; }
+
+		meta_declare(Scaler);
+	};
+
+	meta_define(Scaler)
+		.method("scale", &Scaler::scale)
+		.method("label", &Scaler::label)
+		.finish();
+
+	void BasicTest()
+	{
+	#if META_TRACING
+		using namespace meta::tracing;
+
+		Scaler scaler;
+		const meta::Method* scale = meta::Get<Scaler>()->GetMethod("scale");
+
+		// not traced while disabled
+		meta::Invoke(scale, scaler, 1);
+
+		SetRecordArguments(true);
+		SetEnabled(true);
+		meta::Invoke(scale, scaler, 7);
+
+		std::thread worker([&]() { Scaler local; meta::Invoke(scale, local, 11); });
+		worker.join();
+
+		// wrapping keeps the newest calls
+		for(unsigned int i = 0; i < c_traceBufferEvents; ++i)
+		{
+			meta::Invoke(scale, scaler, 5);
+		}
+		meta::Invoke(scale, scaler, 9);
+
+		// a string's bytes point elsewhere, so only the int is recorded
+		meta::Invoke(meta::Get<Scaler>()->GetMethod("label"), scaler, std::string("a label longer than the small string buffer"), 4);
+		SetEnabled(false);
+		SetRecordArguments(false);
+
+		std::stringstream binary;
+		DumpBinary(binary);
+
+		std::ostringstream json;
+		assert(ConvertBinaryToChromeTrace(binary, json));
+
+		std::string trace = json.str();
+		assert(trace.find("\"name\":\"TracingTest::Scaler::scale\"") != std::string::npos);
+		assert(trace.find("\"args\":{\"0\":\"9\"}") != std::string::npos);
+		assert(trace.find("\"args\":{\"0\":\"11\"}") != std::string::npos);
+		assert(trace.find("\"args\":{\"0\":\"7\"}") == std::string::npos);
+		assert(trace.find("\"args\":{\"0\":\"(not recorded)\",\"1\":\"4\"}") != std::string::npos);
+
+		std::istringstream garbage("not a trace");
+		std::ostringstream ignored;
+		assert(!ConvertBinaryToChromeTrace(garbage, ignored));
+
+		std::cout << "Tracing: ok" << std::endl;
+	#else
+		std::cout << "Tracing compiled out (META_TRACING=0)" << std::endl;
+	#endif
+	}
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace TracingTest
+{
+	void BasicTest();
+}
@@ -1,5 +1,8 @@
+#pragma once
+
 #include <cstddef> // size_t
 #include <type_traits> // true_type, false_type, is_const, is_same, is_base_ofs
+#include <utility> // index_sequence
 
 namespace expr
 {
@@ -30,26 +33,34 @@ namespace expr
 		////////////////////////////////////////////////////////////////////////////////
 
 		// A helper trait that takes a raw variadic list of types and gets the Nth type in the list.
+		// Each type becomes a base class tagged with its index, and the Nth one is picked by overload
+		// resolution, so lookups don't recurse through the list. Out of range indices give void.
 
-		template <size_t Idx, typename... Args>
-		struct type_list;
-
-		template <size_t Idx, typename Current, typename... Args>
-		struct type_list<Idx, Current, Args...>
+		template <size_t Idx, typename T>
+		struct type_list_entry
 		{
-			typedef typename type_list<Idx - 1, Args...>::type type;
+			typedef T type;
 		};
 
-		template <size_t Idx>
-		struct type_list<Idx>
+		template <typename Sequence, typename... Args>
+		struct type_list_entries;
+
+		template <size_t... Is, typename... Args>
+		struct type_list_entries<std::index_sequence<Is...>, Args...> : type_list_entry<Is, Args>...
 		{
-			typedef void type;
 		};
 
-		template <typename Curr, typename... Args>
-		struct type_list<0, Curr, Args...>
+		template <size_t Idx, typename T>
+		type_list_entry<Idx, T> type_list_lookup(const type_list_entry<Idx, T>*);
+
+		template <size_t Idx>
+		type_list_entry<Idx, void> type_list_lookup(const void*);
+
+		template <size_t Idx, typename... Args>
+		struct type_list
 		{
-			typedef Curr type;
+			typedef typename decltype(type_list_lookup<Idx>(
+				static_cast<type_list_entries<std::index_sequence_for<Args...>, Args...>*>(nullptr)))::type type;
 		};
 
 
@@ -259,6 +270,86 @@ namespace expr
 			typedef typename type_list<Idx, Args...>::type type;
 		};
 
+		////////////////////////////////////////////////////////////////////////////////
+		// type_pack / argument_types
+		////////////////////////////////////////////////////////////////////////////////
+
+		// Holds a raw variadic list of types, so a whole parameter list can be passed as one type.
+		template <typename... Args>
+		struct type_pack
+		{
+			static const size_t size = sizeof...(Args);
+		};
+
+		template <typename T>
+		struct argument_types
+		{
+			typedef type_pack<> type;
+		};
+
+		template <typename Ret, typename... Args>
+		struct argument_types<Ret(*)(Args...)>
+		{
+			typedef type_pack<Args...> type;
+		};
+
+		template <typename Ret, typename... Args>
+		struct argument_types<Ret(*)(Args..., ...)>
+		{
+			typedef type_pack<Args...> type;
+		};
+
+		template <typename Ret, typename Caller, typename... Args>
+		struct argument_types<Ret(Caller::*)(Args...)>
+		{
+			typedef type_pack<Args...> type;
+		};
+
+		template <typename Ret, typename Caller, typename... Args>
+		struct argument_types<Ret(Caller::*)(Args..., ...)>
+		{
+			typedef type_pack<Args...> type;
+		};
+
+		template <typename Ret, typename Caller, typename... Args>
+		struct argument_types<Ret(Caller::*)(Args...) const>
+		{
+			typedef type_pack<Args...> type;
+		};
+
+		template <typename Ret, typename Caller, typename... Args>
+		struct argument_types<Ret(Caller::*)(Args..., ...) const>
+		{
+			typedef type_pack<Args...> type;
+		};
+
+		////////////////////////////////////////////////////////////////////////////////
+		// descriptor_table
+		////////////////////////////////////////////////////////////////////////////////
+
+		// Builds constant-initialized Descriptors for a return type and a type_pack of arguments.
+		// params has one trailing default Descriptor, so functions with no arguments still get an array.
+
+		template <typename Descriptor, typename Ret, typename Pack>
+		struct descriptor_table;
+
+		template <typename Descriptor, typename Ret, typename... Args>
+		struct descriptor_table<Descriptor, Ret, type_pack<Args...>>
+		{
+			static constexpr size_t count = sizeof...(Args);
+			static constexpr Descriptor ret = Descriptor::template make<Ret>();
+			static constexpr Descriptor params[sizeof...(Args) + 1] = { Descriptor::template make<Args>()..., Descriptor() };
+		};
+
+		template <typename Descriptor, typename Ret, typename... Args>
+		constexpr size_t descriptor_table<Descriptor, Ret, type_pack<Args...>>::count;
+
+		template <typename Descriptor, typename Ret, typename... Args>
+		constexpr Descriptor descriptor_table<Descriptor, Ret, type_pack<Args...>>::ret;
+
+		template <typename Descriptor, typename Ret, typename... Args>
+		constexpr Descriptor descriptor_table<Descriptor, Ret, type_pack<Args...>>::params[sizeof...(Args) + 1];
+
 		////////////////////////////////////////////////////////////////////////////////
 		// argument_count
 		////////////////////////////////////////////////////////////////////////////////
@@ -315,7 +406,7 @@ namespace expr
 	////////////////////////////////////////////////////////////////////////////////
 
 	// Global Value Expression
-	template <typename Ret>
+	template <typename Ret, typename Enable = void>
 	struct expression
 	{
 		typedef Ret type;
@@ -363,6 +454,43 @@ namespace expr
 		typedef Ret(Caller::*type)(Args..., ...) const;
 	};
 
+	// Noexcept Static Function Substitution
+	template <typename Ret, typename... Args>
+	struct expression<Ret(*)(Args...) noexcept>
+	{
+		typedef Ret(*type)(Args...);
+	};
+
+	// Ref-Qualified / Noexcept Method Substitution
+	// These evaluate the same as the plain (const) method. 
+	#define EXPR_METHOD_SUBSTITUTION(QUALIFIERS, CONST_QUALIFIER)				\
+	template <typename Ret, typename Caller, typename... Args>					\
+	struct expression<Ret(Caller::*)(Args...) QUALIFIERS>						\
+	{																			\
+		typedef Ret(Caller::*type)(Args...) CONST_QUALIFIER;					\
+	};
+
+	EXPR_METHOD_SUBSTITUTION(&, )
+	EXPR_METHOD_SUBSTITUTION(&&, )
+	EXPR_METHOD_SUBSTITUTION(const &, const)
+	EXPR_METHOD_SUBSTITUTION(const &&, const)
+	EXPR_METHOD_SUBSTITUTION(noexcept, )
+	EXPR_METHOD_SUBSTITUTION(& noexcept, )
+	EXPR_METHOD_SUBSTITUTION(&& noexcept, )
+	EXPR_METHOD_SUBSTITUTION(const noexcept, const)
+	EXPR_METHOD_SUBSTITUTION(const & noexcept, const)
+	EXPR_METHOD_SUBSTITUTION(const && noexcept, const)
+
+	#undef EXPR_METHOD_SUBSTITUTION
+
+	// Callable Object Substitution (lambdas, functors)
+	// Evaluates as the object's operator(). Overloaded or templated operator() is not supported.
+	template <typename Callable>
+	struct expression<Callable, typename std::enable_if<std::is_class<Callable>::value, decltype((void)&Callable::operator())>::type>
+	: public expression<decltype(&Callable::operator())>
+	{
+	};
+
 	// Global Pointer Substitution
 	template <typename Ret>
 	struct expression<Ret*>
@@ -424,6 +552,30 @@ namespace expr
 	template <typename Info, size_t Idx>
 	using argument_type = typename detail::argument_type<typename Info::type, Idx>::type;
 
+	/*!
+	 * @class argument_types
+	 * @file expressions
+	 * Returns the detail::argument_types<expression::type>::type of an expression.
+	 * This is a detail::type_pack holding every argument type, in order.
+	 */
+	template <typename Info>
+	using argument_types = typename detail::argument_types<typename Info::type>::type;
+
+	/*!
+	 * @class signature_descriptors
+	 * @file expressions
+	 * Compile-time descriptors of an expression's signature, built by Descriptor.
+	 * Descriptor needs a constexpr default constructor and a
+	 * `template <typename T> static constexpr Descriptor make()`.
+	 * signature_descriptors<expression, D>::ret    -> D for the return type.
+	 * signature_descriptors<expression, D>::params -> D[argument_count + 1], last entry is D().
+	 */
+	template <typename Info, typename Descriptor>
+	struct signature_descriptors
+	: public detail::descriptor_table<Descriptor, return_type<Info>, argument_types<Info>>
+	{
+	};
+
 	/*!
 	 * @class return_expression
 	 * @file expressions
@@ -3,13 +3,50 @@
 #include "ExpressionTest.h"
 #include "MetaTest.h"
 #include "MetaProgrammingTests.h"
+#include "InstrumentationTest.h"
+#include "TracingTest.h"
+#include "LifecycleTest.h"
+#include "LayoutTest.h"
+#include "ColumnTest.h"
+#include "ArchetypeTest.h"
+#include "QueryTest.h"
+#include "SortTest.h"
+#include "HashTest.h"
+#include "CloneTest.h"
+#include "MigrationTest.h"
+#include "MemoTest.h"
+#include "ConvertTest.h"
+#include "CallSiteTest.h"
+#include "ReturnSlotTest.h"
+#include "LogTest.h"
+#include "JournalTest.h"
 
 int main(int argc, const char* argv[])
 {
 	AnyTest::BasicTest();
+	AnyTest::SharedTest();
 	ExpressionTest::BasicTest();
 	MetaTest::Test1();
+	MetaTest::ForwardingTest();
+	InstrumentationTest::BasicTest();
+	TracingTest::BasicTest();
+	LifecycleTest::BasicTest();
+	LayoutTest::BasicTest();
+	ColumnTest::BasicTest();
+	ArchetypeTest::BasicTest();
+	QueryTest::BasicTest();
+	SortTest::BasicTest();
+	HashTest::BasicTest();
+	CloneTest::BasicTest();
+	MigrationTest::BasicTest();
+	MemoTest::BasicTest();
+	ConvertTest::BasicTest();
+	CallSiteTest::BasicTest();
+	ReturnSlotTest::BasicTest();
+	LogTest::BasicTest();
+	JournalTest::BasicTest();
 
+	SelectParameterTest();
 	IndicesExpansionTest();
 	GetParamtest2();
 
@@ -8,9 +8,9 @@ template<typename T>
 class static_vector : public std::vector<T>
 {
 public:
-	static_vector(size_type max_size) : 
+	static_vector(typename std::vector<T>::size_type max_size) : 
 		std::vector<T>()
 	{
-		reserve(max_size);
+		this->reserve(max_size);
 	}
 };
\ No newline at end of file